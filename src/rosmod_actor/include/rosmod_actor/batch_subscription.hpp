@@ -0,0 +1,155 @@
+/** @file    batch_subscription.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the classes batching subscription messages
+ */
+
+#ifndef BATCH_SUBSCRIPTION_HPP
+#define BATCH_SUBSCRIPTION_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include "rosmod_actor/timer_engine.hpp"
+
+#include "ros/ros.h"
+#include "ros/callback_queue.h"
+
+/**
+ * @brief Callback queue running callbacks as soon as they are added.
+ *
+ * Subscriptions on this queue run their callbacks on the roscpp thread
+ * receiving the message, instead of waiting for a component thread.
+ */
+class InlineCallbackQueue : public ros::CallbackQueueInterface {
+public:
+  virtual void addCallback(const ros::CallbackInterfacePtr& callback, uint64_t /*owner_id*/ = 0) {
+    callback->call();
+  }
+
+  virtual void removeByID(uint64_t /*owner_id*/) {}
+};
+
+/**
+ * @brief Collects a topic's messages and delivers them in batches.
+ *
+ * push() appends to the pending batch on the receiving thread. A full batch
+ * queues a single delivery on the component queue; otherwise the first
+ * message of a batch sets a one-shot deadline, which flush()es the partial
+ * batch when its delay is up. Either way the component callback runs on the
+ * component thread with at most max_messages messages at a time.
+ */
+template <class M>
+class BatchSubscription : public boost::enable_shared_from_this<BatchSubscription<M> > {
+public:
+  typedef boost::shared_ptr<M const> MessagePtr;
+  typedef std::vector<MessagePtr> Batch;
+  typedef boost::function<void(const Batch&)> Callback;
+
+  /**
+   * @param[in] callback component callback taking a batch.
+   * @param[in] max_messages largest batch delivered.
+   * @param[in] queue component queue deliveries run from.
+   * @param[in] owner_id owner id of the queued deliveries.
+   */
+  BatchSubscription(const Callback& callback, size_t max_messages,
+		    ros::CallbackQueueInterface* queue, uint64_t owner_id)
+    : callback_(callback), max_messages_(std::max<size_t>(max_messages, 1)),
+      queue_(queue), owner_id_(owner_id), delivery_queued_(false), max_delay_(0) {
+    pending_.reserve(max_messages_);
+  }
+
+  /**
+   * @brief Set the one-shot timer flushing a partial batch; call before the
+   *        first push().
+   * @param[in] deadline one-shot timer calling flush().
+   * @param[in] max_delay seconds the first message of a batch may wait.
+   */
+  void set_deadline(const PeriodicTimerPtr& deadline, double max_delay) {
+    deadline_ = deadline;
+    max_delay_ = std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::duration<double>(max_delay));
+  }
+
+  /**
+   * @brief Add a received message; runs on the receiving thread.
+   */
+  void push(const MessagePtr& message) {
+    bool full;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(message);
+      full = pending_.size() >= max_messages_ && !delivery_queued_;
+      if (full)
+	delivery_queued_ = true;
+      else if (pending_.size() == 1 && deadline_)
+	TimerEngine::instance().expire_in(deadline_, max_delay_);
+    }
+    if (full)
+      queue_->addCallback(ros::CallbackInterfacePtr(new Delivery(this->shared_from_this())),
+			  owner_id_);
+  }
+
+  /**
+   * @brief Deliver the pending messages, if any; runs on the component thread.
+   */
+  void flush() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      delivering_.swap(pending_);
+      delivery_queued_ = false;
+      // the next push() sets a new deadline; disarming under the lock keeps
+      // it from disarming that one
+      if (deadline_)
+	TimerEngine::instance().disarm(deadline_);
+    }
+    if (delivering_.size() <= max_messages_) {
+      if (!delivering_.empty())
+	callback_(delivering_);
+    } else {
+      // The component fell behind: deliver in batches of max_messages
+      for (size_t i = 0; i < delivering_.size(); i += max_messages_) {
+	size_t end = std::min(i + max_messages_, delivering_.size());
+	Batch batch(delivering_.begin() + i, delivering_.begin() + end);
+	callback_(batch);
+      }
+    }
+    // keep the capacity for the next batch
+    delivering_.clear();
+  }
+
+private:
+  /**
+   * @brief Queue entry delivering a full batch.
+   */
+  class Delivery : public ros::CallbackInterface {
+  public:
+    Delivery(const boost::shared_ptr<BatchSubscription>& subscription)
+      : subscription_(subscription) {}
+
+    virtual CallResult call() {
+      subscription_->flush();
+      return Success;
+    }
+
+  private:
+    boost::shared_ptr<BatchSubscription> subscription_;
+  };
+
+  Callback callback_;                   /*!< Component callback */
+  size_t max_messages_;                 /*!< Largest batch delivered */
+  ros::CallbackQueueInterface* queue_;  /*!< Component queue */
+  uint64_t owner_id_;                   /*!< Owner id of queued deliveries */
+  std::mutex mutex_;                    /*!< Guards pending_, delivery_queued_ and the deadline */
+  Batch pending_;                       /*!< Messages received since the last delivery */
+  bool delivery_queued_;                /*!< Is a Delivery in the component queue? */
+  PeriodicTimerPtr deadline_;           /*!< One-shot timer flushing a partial batch */
+  std::chrono::nanoseconds max_delay_;  /*!< Longest wait of a batch's first message */
+  Batch delivering_;                    /*!< Batch being delivered; component thread only */
+};
+
+#endif
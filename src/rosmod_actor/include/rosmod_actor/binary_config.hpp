@@ -0,0 +1,76 @@
+/** @file    binary_config.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the BinaryConfig class
+ */
+
+#ifndef BINARY_CONFIG_HPP
+#define BINARY_CONFIG_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief Precompiled (binary) form of a deployment configuration.
+ *
+ * The file starts with the 8 byte magic "RMODCFG1" followed by the root
+ * value, serialized depth first. Every value is a one byte type tag and its
+ * payload, with all integers little-endian:
+ *
+ *   null                   -
+ *   false / true           -
+ *   int / uint / real      8 bytes
+ *   string                 u32 length, bytes, '\0'
+ *   array                  u32 count, count values
+ *   object                 u32 count, count times (string key, value)
+ *
+ * Loading maps the file read-only and builds the Json::Value tree with
+ * strings and member names pointing into the mapping, so no string data is
+ * copied or parsed. The mapping therefore has to outlive the loaded tree
+ * (and any copies of it).
+ */
+class BinaryConfig {
+public:
+  /**
+   * @brief BinaryConfig Constructor.
+   */
+  BinaryConfig();
+
+  /**
+   * @brief Unmaps the loaded file; values loaded from it become invalid.
+   */
+  ~BinaryConfig();
+
+  /**
+   * @brief Check whether a file starts with the binary config magic.
+   * @param[in] path path to the configuration file.
+   */
+  static bool is_binary(const std::string& path);
+
+  /**
+   * @brief Serialize a configuration into the binary format.
+   * @param[in] root configuration to serialize.
+   * @param[in] out stream to write to; should be opened in binary mode.
+   */
+  static bool write(const Json::Value& root, std::ostream& out);
+
+  /**
+   * @brief Map a binary config file and build its value tree.
+   * @param[in] path path to the binary configuration file.
+   * @param[out] root receives the configuration.
+   * @return false if the file can't be mapped or is malformed.
+   */
+  bool load(const std::string& path, Json::Value& root);
+
+private:
+  BinaryConfig(const BinaryConfig&);             // no impl
+  BinaryConfig& operator=(const BinaryConfig&);  // no impl
+
+  void unmap();
+
+  void* mapping_;   /*!< Start of the mapped file */
+  size_t size_;     /*!< Size of the mapping in bytes */
+};
+
+#endif
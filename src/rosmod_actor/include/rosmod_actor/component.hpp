@@ -8,14 +8,43 @@
 #ifndef COMPONENT_HPP
 #define COMPONENT_HPP
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/weak_ptr.hpp>
 #include <std_msgs/Bool.h>
+#include "rosmod_actor/batch_subscription.hpp"
 #include "rosmod_actor/logger.hpp"
+#include "rosmod_actor/message_pool.hpp"
 #include "rosmod_actor/json.hpp"
+#include "rosmod_actor/replay.hpp"
+#include "rosmod_actor/timer_engine.hpp"
+#include "rosmod_actor/traced_callback_queue.hpp"
 
 #include "ros/ros.h"
 #include "ros/callback_queue.h"
+#include "ros/serialization.h"
+
+/**
+ * @brief CPU usage of a component thread, accumulated over its samples.
+ */
+struct CpuUsage {
+  uint64_t samples;         /*!< Samples taken */
+  double cpu_us;            /*!< Thread CPU time at the last sample */
+  long voluntary;           /*!< Voluntary context switches at the last sample */
+  long involuntary;         /*!< Involuntary context switches at the last sample */
+  double latency_sum_us;    /*!< Total scheduling latency of the samples */
+  double latency_max_us;    /*!< Largest scheduling latency of a sample */
+  std::chrono::steady_clock::time_point start;  /*!< When accounting started */
+  std::chrono::steady_clock::time_point last;   /*!< When the last sample was taken */
+  PeriodicTimerPtr timer;   /*!< Sampling timer */
+};
 
 /**
  * @brief Component class
@@ -24,9 +53,19 @@ class Component {
 public:
   /**
    * @brief Component Constructor.
+   *
+   * The configuration is referenced, not copied, so it must outlive the
+   * component. rosmod_actor keeps the deployment document alive for the
+   * lifetime of the process.
    * @param[in] _config Component configuration parsed from deployment JSON
    */
-  Component(Json::Value& _config);
+  Component(const Json::Value& _config);
+
+  /**
+   * @brief Component Constructor taking ownership of its configuration.
+   * @param[in] _config Component configuration; moved from, not copied
+   */
+  Component(Json::Value&& _config);
 
   /**
    * @brief Component Destructor
@@ -53,14 +92,281 @@ public:
    */
   virtual void process_queue();
 
+  /**
+   * @brief Stop the component.
+   *
+   * Shuts down the component's node handle (its timers, publishers and
+   * subscribers), which makes process_queue() return; pending callbacks are
+   * dropped and new ones are refused. Called from the main thread during
+   * shutdown or reload, possibly while the component thread is still inside
+   * a callback. Components running their own threads should extend this to
+   * stop them.
+   */
+  virtual void stop();
+
+  /**
+   * @brief Write out the buffered user and trace logs.
+   */
+  void flush_logs();
+
+  /**
+   * @brief Queue a recorded event on the component message queue.
+   *
+   * On the component thread, the event is passed to the replay handler
+   * registered for its channel and the handler's execution time recorded.
+   * @param[in] event recorded event.
+   * @param[in] scheduled when the event was due, to measure dispatch delay.
+   */
+  void replay(const ReplayEvent& event,
+	      std::chrono::steady_clock::time_point scheduled);
+
+  /**
+   * @brief Check whether all queued replay events have been handled.
+   */
+  bool replay_idle() const;
+
+  /**
+   * @brief Timings of the replayed events, by channel.
+   *
+   * Only safe to read while replay_idle() is true.
+   */
+  const std::map<std::string, ReplayStats>& replay_stats() const;
+
 protected:
+  typedef boost::function<void(const ReplayEvent&)> ReplayHandler;
+
+  /**
+   * @brief Register the handler replaying recorded events of a channel.
+   * @param[in] channel topic or timer name used in the replay log.
+   * @param[in] handler called on the component thread for each event.
+   */
+  void register_replay_handler(const std::string& channel,
+			       const ReplayHandler& handler);
+
+  /**
+   * @brief Replay recorded messages of a topic into a subscriber callback.
+   * @param[in] topic topic name used in the replay log.
+   * @param[in] callback subscriber callback.
+   * @param[in] obj component the callback belongs to.
+   */
+  template <class M, class T>
+  void register_replay_subscriber(const std::string& topic,
+				  void (T::*callback)(const boost::shared_ptr<M const>&),
+				  T* obj) {
+    boost::function<boost::shared_ptr<M>()> factory = message_factory<M>(topic);
+    register_replay_handler(topic, [obj, callback, factory](const ReplayEvent& event) {
+      boost::shared_ptr<M> msg = factory();
+      ros::serialization::IStream stream(const_cast<uint8_t*>(event.payload.data()),
+					 static_cast<uint32_t>(event.payload.size()));
+      ros::serialization::deserialize(stream, *msg);
+      (obj->*callback)(msg);
+    });
+  }
+
+  /**
+   * @brief Replay recorded ticks of a timer into its callback.
+   *
+   * The timer event carries the recorded times of this and the previous tick.
+   * @param[in] timer timer name used in the replay log.
+   * @param[in] callback timer callback.
+   * @param[in] obj component the callback belongs to.
+   */
+  template <class T>
+  void register_replay_timer(const std::string& timer,
+			     void (T::*callback)(const ros::TimerEvent&),
+			     T* obj) {
+    boost::shared_ptr<ros::Time> last(new ros::Time());
+    register_replay_handler(timer, [obj, callback, last](const ReplayEvent& event) {
+      ros::TimerEvent timer_event;
+      timer_event.last_expected = timer_event.last_real = *last;
+      timer_event.current_real.fromNSec(event.stamp);
+      timer_event.current_expected = timer_event.current_real;
+      *last = timer_event.current_real;
+      (obj->*callback)(timer_event);
+    });
+  }
+
+  /**
+   * @brief Start a periodic timer on the actor's timer engine.
+   *
+   * Unlike a ros::Timer, its expiries are scheduled at absolute times, so
+   * they don't drift. The lateness of its callbacks is written to the
+   * component log when the component is destroyed.
+   * @param[in] name timer name used in the log.
+   * @param[in] period timer period in seconds.
+   * @param[in] callback timer callback, run from comp_queue.
+   * @param[in] obj component the callback belongs to.
+   */
+  template <class T>
+  PeriodicTimerPtr create_periodic_timer(const std::string& name, double period,
+					 void (T::*callback)(const ros::TimerEvent&),
+					 T* obj) {
+    return add_periodic_timer(name, period, [obj, callback](const ros::TimerEvent& event) {
+      (obj->*callback)(event);
+    });
+  }
+
+  /**
+   * @brief Start a periodic timer on the actor's timer engine.
+   * @see create_periodic_timer()
+   */
+  PeriodicTimerPtr add_periodic_timer(const std::string& name, double period,
+				      const PeriodicTimer::Callback& callback);
+
+  /**
+   * @brief Create a one-shot timer on the actor's timer engine, expiring
+   *        only when set with TimerEngine::expire_in().
+   * @param[in] name timer name used in the log.
+   * @param[in] callback timer callback, run from comp_queue.
+   */
+  PeriodicTimerPtr add_once_timer(const std::string& name,
+				  const PeriodicTimer::Callback& callback);
+
+  /**
+   * @brief Message factory recycling the messages received on a topic.
+   *
+   * Pass it to SubscribeOptions::init() to have roscpp deserialize into
+   * pooled messages instead of allocating each one. The pool keeps up to
+   * "Message Pool Size" (default 64) messages; its hit rate is written to
+   * the trace log when the component is destroyed.
+   * @param[in] topic topic the factory is used for.
+   */
+  template <class M>
+  boost::function<boost::shared_ptr<M>()> message_factory(const std::string& topic) {
+    std::lock_guard<std::mutex> lock(message_pools_mutex_);
+    std::shared_ptr<MessagePoolBase>& entry = message_pools_[topic];
+    std::shared_ptr<MessagePool<M> > pool = std::dynamic_pointer_cast<MessagePool<M> >(entry);
+    if (!pool) {
+      if (entry)
+	ROS_ERROR_STREAM("Topic " << topic << " is used with two message types; " <<
+			 "only the last one is pooled");
+      pool.reset(new MessagePool<M>(topic, config.get("Message Pool Size", 64).asUInt()));
+      entry = pool;
+    }
+    return [pool]() { return pool->acquire(); };
+  }
+
+  /**
+   * @brief Subscribe to a topic on comp_queue, recycling its messages.
+   * @param[in] topic topic to subscribe to.
+   * @param[in] queue_size roscpp subscription queue size.
+   * @param[in] callback subscriber callback.
+   * @param[in] obj component the callback belongs to.
+   * @see message_factory()
+   */
+  template <class M, class T>
+  ros::Subscriber create_pooled_subscriber(const std::string& topic, uint32_t queue_size,
+					   void (T::*callback)(const boost::shared_ptr<M const>&),
+					   T* obj) {
+    ros::SubscribeOptions options;
+    options.init<M>(topic, queue_size, [obj, callback](const boost::shared_ptr<M const>& message) {
+      (obj->*callback)(message);
+    }, message_factory<M>(topic));
+    options.callback_queue = &comp_queue;
+    return nh_.subscribe(options);
+  }
+
+  /**
+   * @brief Subscribe to a topic, receiving its messages in batches.
+   *
+   * Messages are collected as they arrive and handed to the callback
+   * together, once "Max Messages" have arrived or "Max Delay" seconds have
+   * passed, as set for the topic under "Batching" in the component's
+   * configuration:
+   *
+   *   "Batching": { "<topic>": { "Max Messages": 64, "Max Delay": 0.001 } }
+   *
+   * Each batch costs a single comp_queue callback. The delay is a one-shot
+   * deadline set when the first message of a batch arrives, so a quiet
+   * topic costs no timer wakeups.
+   * @param[in] topic topic to subscribe to.
+   * @param[in] queue_size roscpp subscription queue size.
+   * @param[in] callback subscriber callback taking a batch of messages.
+   * @param[in] obj component the callback belongs to.
+   */
+  template <class M, class T>
+  ros::Subscriber create_batch_subscriber(const std::string& topic, uint32_t queue_size,
+					  void (T::*callback)(const std::vector<boost::shared_ptr<M const> >&),
+					  T* obj) {
+    typedef BatchSubscription<M> Batcher;
+    size_t max_messages;
+    double max_delay;
+    batch_limits(topic, max_messages, max_delay);
+    boost::shared_ptr<Batcher> batcher(new Batcher([obj, callback](const typename Batcher::Batch& batch) {
+      (obj->*callback)(batch);
+    }, max_messages, &comp_queue, reinterpret_cast<uint64_t>(this)));
+    // the deadline doesn't keep the batcher alive, the subscription does
+    boost::weak_ptr<Batcher> weak_batcher(batcher);
+    batcher->set_deadline(add_once_timer(topic + " batch", [weak_batcher](const ros::TimerEvent&) {
+      if (boost::shared_ptr<Batcher> deadline_batcher = weak_batcher.lock())
+	deadline_batcher->flush();
+    }), max_delay);
+
+    // The messages are collected as they are received
+    ros::SubscribeOptions options;
+    options.init<M>(topic, queue_size, [batcher](const boost::shared_ptr<M const>& message) {
+      batcher->push(message);
+    }, message_factory<M>(topic));
+    options.callback_queue = &batch_collector_;
+    options.allow_concurrent_callbacks = true;
+    return nh_.subscribe(options);
+  }
+
+  /**
+   * @brief Look up the batching of a topic in the configuration.
+   * @param[in] topic topic as passed to create_batch_subscriber().
+   * @param[out] max_messages "Max Messages", default 64.
+   * @param[out] max_delay "Max Delay" in seconds, default 0.001.
+   */
+  void batch_limits(const std::string& topic, size_t& max_messages, double& max_delay) const;
+
   ros::NodeHandle          nh_;         /*!< NodeHandle */
-  Json::Value              config;      /*!< Component Configuration */
+  std::unique_ptr<const Json::Value> owned_config_; /*!< Configuration moved into the component, if any */
+  const Json::Value&       config;      /*!< Component Configuration (read-only) */
   ros::Timer               init_timer;  /*!< Initialization timer */
-  ros::CallbackQueue       comp_queue;  /*!< Component Message Queue */
+  TracedCallbackQueue      comp_queue;  /*!< Component Message Queue */
   std::unique_ptr<Logger>  logger;      /*!< Component logger object */
   std::unique_ptr<Logger>  trace;       /*!< Component trace logger object */
   std::string              workingDir;  /*!< Working directory of the process */
+
+private:
+  friend class ReplayCallback;
+
+  /**
+   * @brief Common constructor body, run once config is bound
+   */
+  void init();
+
+  /**
+   * @brief Run a replayed event's handler and record its timings.
+   */
+  void run_replay_event(const ReplayEvent& event,
+			std::chrono::steady_clock::time_point scheduled);
+
+  /**
+   * @brief Cancel all timers started with add_periodic_timer() or add_once_timer().
+   */
+  void cancel_periodic_timers();
+
+  /**
+   * @brief Trace the CPU time, context switches and scheduling latency of
+   *        the component thread since the previous sample.
+   *
+   * Runs on the component thread every "CPU Accounting Interval" seconds.
+   * The latency is how late the sampling timer's callback started after
+   * its steady-clock expiry, as in the timer's lateness statistics.
+   */
+  void sample_cpu_usage();
+
+  std::map<std::string, ReplayHandler> replay_handlers_; /*!< Replay handlers by channel */
+  std::map<std::string, ReplayStats> replay_stats_;      /*!< Replay timings by channel */
+  std::atomic<unsigned int> replay_pending_;             /*!< Queued, unhandled replay events */
+  std::mutex periodic_timers_mutex_;                     /*!< Guards periodic_timers_ */
+  std::vector<PeriodicTimerPtr> periodic_timers_;        /*!< Timers on the timer engine */
+  InlineCallbackQueue batch_collector_;                  /*!< Collects batched messages on receipt */
+  std::mutex message_pools_mutex_;                       /*!< Guards message_pools_ */
+  std::map<std::string, std::shared_ptr<MessagePoolBase> > message_pools_; /*!< Message pools by topic */
+  CpuUsage cpu_usage_;                                   /*!< CPU accounting; component thread only */
 };
 
 #endif
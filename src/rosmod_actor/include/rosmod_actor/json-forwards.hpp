@@ -290,6 +290,8 @@ class StyledWriter;
 
 // reader.h
 class Reader;
+class StreamHandler;
+class StreamReader;
 
 // features.h
 class Features;
@@ -297,6 +299,7 @@ class Features;
 // value.h
 typedef unsigned int ArrayIndex;
 class StaticString;
+class Key;
 class Path;
 class PathArgument;
 class Value;
@@ -323,6 +323,8 @@ class StyledWriter;
 
 // reader.h
 class Reader;
+class StreamHandler;
+class StreamReader;
 
 // features.h
 class Features;
@@ -330,6 +332,7 @@ class Features;
 // value.h
 typedef unsigned int ArrayIndex;
 class StaticString;
+class Key;
 class Path;
 class PathArgument;
 class Value;
@@ -565,6 +568,48 @@ private:
   const char* c_str_;
 };
 
+/** \brief Reusable handle to an object member name.
+ *
+ * The name is interned on construction in a process-wide table, so Keys
+ * built from equal names share one copy of it for the life of the process.
+ * A Key also remembers the member it last resolved: looking it up again in
+ * the same, unmodified object compares two integers instead of searching
+ * the member map.
+ *
+ * Example of usage:
+ * \code
+ * Json::Key period("Period");
+ * while (running)
+ *   sleep(config[period].asInt());
+ * \endcode
+ *
+ * \note The cached lookup is not synchronized. Don't use one Key from
+ * several threads at once; give each thread (or component) its own.
+ */
+class JSON_API Key {
+public:
+  explicit Key(const char* key);
+  /// \param key may contain embedded nulls.
+  explicit Key(const JSONCPP_STRING& key);
+
+  const char* data() const;
+  unsigned length() const;
+
+  /// Names are interned, so this is a pointer compare.
+  bool operator==(const Key& other) const;
+  bool operator!=(const Key& other) const;
+
+private:
+  friend class Value;
+
+  const JSONCPP_STRING* name_;
+  // Last lookup: identity and mutation count of the member map it was made
+  // in (identity 0 if none yet) and the member found there, or NULL.
+  mutable LargestUInt identity_;
+  mutable LargestUInt mutations_;
+  mutable const Value* member_;
+};
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represents a:
@@ -681,11 +726,7 @@ private:
   };
 
 public:
-#ifndef JSON_USE_CPPTL_SMALLMAP
-  typedef std::map<CZString, Value> ObjectValues;
-#else
-  typedef CppTL::SmallMap<CZString, Value> ObjectValues;
-#endif // ifndef JSON_USE_CPPTL_SMALLMAP
+  class ObjectValues;
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
 public:
@@ -888,6 +929,12 @@ Json::Value obj_value(Json::objectValue); // {}
    * \endcode
    */
   Value& operator[](const StaticString& key);
+  /// Access an object value by Key, create a null member if it does not
+  /// exist. The member name of a new entry points to the interned name.
+  Value& operator[](const Key& key);
+  /// Access an object value by Key, returns null if there is no member with
+  /// that name.
+  const Value& operator[](const Key& key) const;
 #ifdef JSON_USE_CPPTL
   /// Access an object value by name, create a null member if it does not exist.
   Value& operator[](const CppTL::ConstString& key);
@@ -906,6 +953,9 @@ Json::Value obj_value(Json::objectValue); // {}
   /// \note deep copy
   /// \param key may contain embedded nulls.
   Value get(const JSONCPP_STRING& key, const Value& defaultValue) const;
+  /// Return the member named key if it exist, defaultValue otherwise.
+  /// \note deep copy
+  Value get(const Key& key, const Value& defaultValue) const;
 #ifdef JSON_USE_CPPTL
   /// Return the member named key if it exist, defaultValue otherwise.
   /// \note deep copy
@@ -915,6 +965,9 @@ Json::Value obj_value(Json::objectValue); // {}
   /// and operator[]const
   /// \note As stated elsewhere, behavior is undefined if (end-begin) >= 2^30
   Value const* find(char const* begin, char const* end) const;
+  /// Same as find(begin, end), but repeated lookups in an unmodified object
+  /// are answered from the Key without searching.
+  Value const* find(const Key& key) const;
   /// Most general and efficient version of object-mutators.
   /// \note As stated elsewhere, behavior is undefined if (end-begin) >= 2^30
   /// \return non-zero, but JSON_ASSERT if this is neither object nor nullValue.
@@ -959,6 +1012,8 @@ Json::Value obj_value(Json::objectValue); // {}
   bool isMember(const JSONCPP_STRING& key) const;
   /// Same as isMember(JSONCPP_STRING const& key)const
   bool isMember(const char* begin, const char* end) const;
+  /// Return true if the object has a member named key.
+  bool isMember(const Key& key) const;
 #ifdef JSON_USE_CPPTL
   /// Return true if the object has a member named key.
   bool isMember(const CppTL::ConstString& key) const;
@@ -1045,6 +1100,42 @@ private:
   ptrdiff_t limit_;
 };
 
+#ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
+/** \brief Member map of an object or array Value.
+ *
+ * Every map gets a process-unique identity, and inserting or removing
+ * members bumps its mutation count; a Key compares both to tell whether the
+ * member it cached is still valid. The mutators below hide std::map's, so
+ * no change to the map can bypass the count.
+ */
+#ifndef JSON_USE_CPPTL_SMALLMAP
+class Value::ObjectValues : public std::map<Value::CZString, Value> {
+  typedef std::map<Value::CZString, Value> Base;
+#else
+class Value::ObjectValues : public CppTL::SmallMap<Value::CZString, Value> {
+  typedef CppTL::SmallMap<Value::CZString, Value> Base;
+#endif // ifndef JSON_USE_CPPTL_SMALLMAP
+public:
+  ObjectValues();
+  ObjectValues(const ObjectValues& other);
+
+  iterator insert(iterator position, const value_type& value);
+  void erase(iterator position);
+  size_type erase(const key_type& key);
+  void clear();
+  mapped_type& operator[](const key_type& key);
+
+  LargestUInt identity() const { return identity_; }
+  LargestUInt mutations() const { return mutations_; }
+
+private:
+  ObjectValues& operator=(const ObjectValues&); // no impl
+
+  LargestUInt identity_;
+  LargestUInt mutations_;
+};
+#endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
+
 /** \brief Experimental and untested: represents an element of the "path" to
  * access a node.
  */
@@ -1584,6 +1675,54 @@ public:
   };  // Factory
 };  // CharReader
 
+/** \brief Receives the events produced by a StreamReader.
+ *
+ * Every callback returns \c true to continue parsing or \c false to abort
+ * it. The default implementations ignore the event, so a handler only needs
+ * to override the events it is interested in.
+ */
+class JSON_API StreamHandler {
+public:
+  virtual ~StreamHandler() {}
+  virtual bool startObject() { return true; }
+  virtual bool endObject() { return true; }
+  virtual bool startArray() { return true; }
+  virtual bool endArray() { return true; }
+  /// Name of the next object member; followed by its value event(s).
+  virtual bool key(const JSONCPP_STRING& /*name*/) { return true; }
+  /// A null, boolean, number or string value.
+  virtual bool value(const Value& /*value*/) { return true; }
+};  // StreamHandler
+
+/** \brief Event based (SAX-style) reader for JSON that arrives in chunks.
+ *
+ * The input is pushed with feed() as it becomes available and finish() is
+ * called once at the end. Chunks may split the text anywhere, including in
+ * the middle of a token. Only the unconsumed tail of the input and the
+ * container nesting are kept between calls, so memory use does not depend on
+ * the size of the document.
+ *
+ * A stream may hold several top-level values one after another (e.g. one
+ * record per line) unless \c failIfExtra is set.
+ * \c rejectDupKeys and \c allowDroppedNullPlaceholders are not supported.
+ */
+class JSON_API StreamReader {
+public:
+  virtual ~StreamReader() {}
+  /** \brief Parse the next chunk of the document.
+   * \param errs [out] Formatted error messages (if not NULL)
+   * \return \c false if an error occurred or the handler aborted; the reader
+   *         then ignores further input until finish().
+   */
+  virtual bool feed(
+      char const* beginChunk, char const* endChunk,
+      JSONCPP_STRING* errs) = 0;
+  /** \brief Signal the end of the input and reset the reader for reuse.
+   * \return \c false if the input was truncated or an error occurred.
+   */
+  virtual bool finish(JSONCPP_STRING* errs) = 0;
+};  // StreamReader
+
 /** \brief Build a CharReader implementation.
 
 Usage:
@@ -1643,6 +1782,12 @@ public:
 
   CharReader* newCharReader() const JSONCPP_OVERRIDE;
 
+  /** \brief Allocate a StreamReader via operator new(), using the current
+   * settings.
+   * \param handler Receives the parse events; must outlive the reader.
+   */
+  StreamReader* newStreamReader(StreamHandler* handler) const;
+
   /** \return true if 'settings' are legal and consistent;
    *   otherwise, indicate bad settings via 'invalid'.
    */
@@ -1675,6 +1820,15 @@ bool JSON_API parseFromStream(
     JSONCPP_ISTREAM&,
     Value* root, std::string* errs);
 
+/** Read 'sin' in fixed-size chunks and send its parse events to 'handler'.
+  * Unlike the overload above, the document is never held in memory as a
+  * whole.
+  */
+bool JSON_API parseFromStream(
+    CharReaderBuilder const&,
+    JSONCPP_ISTREAM&,
+    StreamHandler* handler, std::string* errs);
+
 /** \brief Read from 'sin' into 'root'.
 
  Always keep comments from the input JSON.
@@ -1898,6 +2052,13 @@ public:
 public: // overridden from Writer
   JSONCPP_STRING write(const Value& root) JSONCPP_OVERRIDE;
 
+  /** \brief Append the serialized root to 'document'.
+   * Reusing the same string for many values avoids a fresh allocation and
+   * a copy of the result per call.
+   * \pre document != NULL
+   */
+  void write(const Value& root, JSONCPP_STRING* document);
+
 private:
   void writeValue(const Value& value);
 
@@ -1943,6 +2104,12 @@ public: // overridden from Writer
    */
   JSONCPP_STRING write(const Value& root) JSONCPP_OVERRIDE;
 
+  /** \brief Append the serialized root to 'document'.
+   * \pre document != NULL
+   * \see FastWriter::write(const Value&, JSONCPP_STRING*)
+   */
+  void write(const Value& root, JSONCPP_STRING* document);
+
 private:
   void writeValue(const Value& value);
   void writeArrayValue(const Value& value);
@@ -0,0 +1,49 @@
+/** @file    log_compression.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the compression of written logs
+ */
+
+#ifndef LOG_COMPRESSION_HPP
+#define LOG_COMPRESSION_HPP
+
+#include <string>
+#include <stddef.h>
+
+/**
+ * @brief Compresses log buffers into self-contained frames.
+ *
+ * Each buffer written becomes one standard frame, and concatenated frames
+ * are a valid stream, so a compressed log can be read with lz4cat or
+ * zstdcat, incrementally, while it is still being written. LZ4 frames are
+ * produced by a bundled encoder with 64 KB independent blocks; zstd needs
+ * the actor to be built with libzstd (ROSMOD_ACTOR_ZSTD).
+ */
+class LogCompressor {
+public:
+  enum Method {
+    none = 0,  /*!< Written as is */
+    lz4 = 1,   /*!< LZ4 frames */
+    zstd = 2   /*!< Zstandard frames */
+  };
+
+  /**
+   * @brief Parse a "Compression" setting: "None", "LZ4" or "Zstd".
+   *
+   * "Zstd" gives lz4 if the actor was built without libzstd.
+   * @param[in] name setting to parse.
+   * @param[out] method the method to use.
+   * @return false if name is none of these.
+   */
+  static bool parse(const std::string& name, Method& method);
+
+  /**
+   * @brief Compress a buffer into one frame.
+   * @param[in] method lz4 or zstd.
+   * @param[in] data buffer to compress.
+   * @param[in] size its size in bytes.
+   * @param[out] frame receives the frame; its capacity is reused.
+   */
+  static void compress(Method method, const char* data, size_t size, std::string& frame);
+};
+
+#endif
@@ -0,0 +1,72 @@
+/** @file    log_rotation.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the background work of log file rotation
+ */
+
+#ifndef LOG_ROTATION_HPP
+#define LOG_ROTATION_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <stddef.h>
+
+/**
+ * @brief Does the slow file system work of rotating logs on its own thread.
+ *
+ * A Logger rotates its file itself, with a rename and an open, and hands
+ * the rest to the rotator: preallocating the new segment with fallocate,
+ * releasing the unused preallocation of the rotated one, and deleting
+ * segments beyond the retention count. Segments of a log at path are named
+ * path.1, path.2, ..., oldest first; path is always the one being written.
+ */
+class LogRotator {
+public:
+  /**
+   * @brief The rotator shared by all loggers; its thread starts on first use.
+   */
+  static LogRotator& instance();
+
+  /**
+   * @brief The highest segment number of a log, or 0 if it has none.
+   * @param[in] path path of the log being written.
+   */
+  static int last_segment(const std::string& path);
+
+  /**
+   * @brief Reserve disk space for a log file, keeping its size.
+   * @param[in] path log file.
+   * @param[in] size bytes to reserve.
+   */
+  void preallocate(const std::string& path, size_t size);
+
+  /**
+   * @brief Finish a rotated segment and apply retention.
+   * @param[in] segment the segment just rotated out.
+   * @param[in] path path of the log being written.
+   * @param[in] oldest_kept segments numbered below this are deleted.
+   */
+  void retire(const std::string& segment, const std::string& path, int oldest_kept);
+
+  /**
+   * @brief Finishes pending work and stops the thread.
+   */
+  ~LogRotator();
+
+private:
+  LogRotator();
+
+  void submit(const std::function<void()>& job);
+  void run();
+
+  std::mutex mutex_;                          /*!< Guards the fields below */
+  std::condition_variable ready_;             /*!< Signals a job or stopping */
+  std::deque<std::function<void()> > jobs_;   /*!< Pending jobs */
+  bool stopping_;                             /*!< Is the thread to exit? */
+  std::thread thread_;                        /*!< Runs the jobs */
+};
+
+#endif
@@ -0,0 +1,125 @@
+/** @file    log_sink.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the raw file descriptor sink of the loggers
+ */
+
+#ifndef LOG_SINK_HPP
+#define LOG_SINK_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief A write handed to the LogSink.
+ *
+ * Its buffers must stay untouched until LogSink::wait() returns for it.
+ */
+struct LogWrite {
+  LogWrite() : fd(-1), size(0), pending(false), finished(false), result(0) {}
+
+  int fd;                          /*!< File written */
+  std::vector<struct iovec> iov;   /*!< Buffers written, in order */
+  size_t size;                     /*!< Total bytes */
+  bool pending;                    /*!< Submitted and not yet waited for */
+  bool finished;                   /*!< Completed, guarded by the sink */
+  int64_t result;                  /*!< Bytes written or -errno */
+};
+
+/**
+ * @brief Writes log buffers straight to file descriptors.
+ *
+ * Each flush of a logger is one gathering writev(), without the copy into
+ * an ofstream's buffer. With "Log Sink": "io_uring" in the deployment
+ * configuration, writes are instead queued on one io_uring shared by all
+ * loggers. Periodic flushes are deferred and submitted together, 16 at a
+ * time or with the next explicit write, by one non-blocking
+ * io_uring_enter(). No write stays unsubmitted for more than 2 ms: the
+ * next write or done() past that submits it, or else the sink's submitter
+ * thread does. Completions are reaped from shared memory. A logger
+ * only waits for the disk if its previous write is still in flight when
+ * it writes again. io_uring needs linux/io_uring.h at build time
+ * (ROSMOD_ACTOR_IO_URING) and a 5.11 or newer kernel; otherwise writev()
+ * is used.
+ */
+class LogSink {
+public:
+  /**
+   * @brief The sink shared by all loggers.
+   */
+  static LogSink& instance();
+
+  /**
+   * @brief Read the "Log Sink" setting: "writev" (the default) or "io_uring".
+   */
+  void configure(const Json::Value& config);
+
+  /**
+   * @brief Append buffers to a file, in order.
+   *
+   * With writev() the write is done on return; with io_uring it is only
+   * queued, and submitted unless deferred.
+   * @param[in] fd file opened with O_APPEND.
+   * @param[in] iov buffers to write.
+   * @param[in] count number of buffers.
+   * @param[out] write the write, to wait() for before reusing the buffers.
+   * @param[in] defer let the write wait for a batch to be submitted.
+   */
+  void write(int fd, const struct iovec* iov, int count, LogWrite& write, bool defer);
+
+  /**
+   * @brief Has a write completed? Never blocks, but submits writes deferred
+   *        for 2 ms or more.
+   */
+  bool done(LogWrite& write);
+
+  /**
+   * @brief Wait for a write to complete, finishing it if it was short.
+   * @return false if it failed.
+   */
+  bool wait(LogWrite& write);
+
+  ~LogSink();
+
+private:
+  LogSink();
+
+  static bool write_all(int fd, std::vector<struct iovec>& iov, size_t skip);
+  bool setup_ring(unsigned entries);
+  void run_submitter();
+  void reap();
+  unsigned unsubmitted() const;
+  int enter(unsigned submit, unsigned complete);
+
+  std::mutex mutex_;            /*!< Guards the ring and the fields below it */
+  std::condition_variable deferred_; /*!< Signals a deferred write or stopping */
+  std::chrono::steady_clock::time_point deferred_since_; /*!< When the oldest unsubmitted write was queued */
+  bool stopping_;               /*!< Is the submitter to exit? */
+  std::thread submitter_;       /*!< Submits writes deferred too long */
+  int ring_fd_;                 /*!< io_uring, or -1 to use writev() */
+  unsigned entries_;            /*!< Submission queue entries */
+  unsigned completions_;        /*!< Completion queue entries */
+  unsigned inflight_;           /*!< Writes submitted, not yet reaped */
+  void* sq_ring_;               /*!< Mapped submission ring */
+  size_t sq_ring_size_;         /*!< Its size */
+  void* cq_ring_;               /*!< Mapped completion ring, maybe sq_ring_ */
+  size_t cq_ring_size_;         /*!< Its size */
+  void* sqes_;                  /*!< Mapped submission entries */
+  size_t sqes_size_;            /*!< Their size */
+  unsigned* sq_head_;           /*!< Consumed by the kernel */
+  unsigned* sq_tail_;           /*!< Produced by us */
+  unsigned* sq_mask_;           /*!< Index mask */
+  unsigned* sq_array_;          /*!< Ring of entry indices */
+  unsigned* cq_head_;           /*!< Consumed by us */
+  unsigned* cq_tail_;           /*!< Produced by the kernel */
+  unsigned* cq_mask_;           /*!< Index mask */
+  void* cqes_;                  /*!< Completion entries */
+};
+
+#endif
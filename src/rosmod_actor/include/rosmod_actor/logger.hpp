@@ -21,6 +21,16 @@
 #include <sstream>
 #include <chrono>
 #include <typeinfo>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "rosmod_actor/log_compression.hpp"
+#include "rosmod_actor/log_rotation.hpp"
+#include "rosmod_actor/log_sink.hpp"
+#include "rosmod_actor/structured_log.hpp"
+#include "rosmod_actor/timeline.hpp"
+#include "rosmod_actor/tracepoints.hpp"
 
 /**
  * @brief Logger class
@@ -34,10 +44,19 @@ public:
    */
   Logger() {
     logs_to_file_ = false;
+    log_fd_ = -1;
     is_periodic_ = true;
     logging_enabled_ = false;
     max_log_unit_ = 1;
-    log_content_ = "=================================================================\n";
+    compression_ = LogCompressor::none;
+    format_ = StructuredLog::text;
+    segment_size_ = 0;
+    segment_interval_ = 0;
+    keep_segments_ = 0;
+    segment_ = -1;
+    segment_bytes_ = 0;
+    dropped_ = 0;
+    log_content_ = banner();
   }
 
   /**
@@ -57,8 +76,11 @@ public:
    */
   void set_max_log_unit(int max_log_unit) {
     {
-      std::lock_guard<std::recursive_mutex> lk(settings_mutex);
+      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
       max_log_unit_ = max_log_unit;
+      // room for a full unit and the entry that overflows it
+      log_content_.reserve(max_log_unit_ + 1024);
     }
   }
 
@@ -73,6 +95,56 @@ public:
     }
   }
 
+  /**
+   * @brief Compress the log file; stdout is never compressed.
+   * @param[in] compression compression of each buffer written out.
+   */
+  void set_compression(LogCompressor::Method compression) {
+    {
+      std::lock_guard<std::recursive_mutex> lk(settings_mutex);
+      compression_ = compression;
+    }
+  }
+
+  /**
+   * @brief Set the output format; call before logging.
+   * @param[in] format text (the default), json or columnar.
+   */
+  void set_format(StructuredLog::Format format) {
+    {
+      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
+      // the banner only belongs in text logs
+      if (format != StructuredLog::text && log_content_ == banner())
+	log_content_.clear();
+      format_ = format;
+    }
+  }
+
+  /**
+   * @brief Rotate the log file into numbered segments.
+   *
+   * The file being written is moved to log_path.N once it holds
+   * segment_size bytes or is segment_interval seconds old, and a new one
+   * is started; 0 disables either limit. New files are preallocated to
+   * segment_size in the background.
+   *
+   * @param[in] segment_size bytes per segment, or 0.
+   * @param[in] segment_interval seconds per segment, or 0.
+   * @param[in] keep_segments rotated segments to keep, or 0 to keep all.
+   */
+  void set_rotation(size_t segment_size, double segment_interval, int keep_segments) {
+    {
+      std::lock_guard<std::mutex> lk0(write_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(settings_mutex);
+      segment_size_ = segment_size;
+      segment_interval_ = segment_interval;
+      keep_segments_ = keep_segments;
+      if (log_fd_ >= 0)
+	start_segment();
+    }
+  }
+
   /**
    * @brief Enable this logger
    */
@@ -99,8 +171,10 @@ public:
   ~Logger() {
     write();
     {
-      std::lock_guard<std::recursive_mutex> lk(io_mutex);
-      log_stream_.close();
+      std::lock_guard<std::mutex> lk(write_mutex);
+      LogSink::instance().wait(written_);
+      if (log_fd_ >= 0)
+	close(log_fd_);
     }
   }
 
@@ -110,53 +184,42 @@ public:
    */
   bool create_file(std::string log_path) {
     {
-      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
-      std::lock_guard<std::recursive_mutex> lk1(io_mutex);
+      std::lock_guard<std::mutex> lk0(write_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(settings_mutex);
       if (logging_enabled_) {
+	LogSink::instance().wait(written_);
+	if (log_fd_ >= 0)
+	  close(log_fd_);
 	log_path_ = log_path;
-	log_stream_.open(log_path_, std::ios::out | std::ios::app);
+	log_fd_ = open_file();
 	logs_to_file_ = true;
-	return true;
+	start_segment();
+	return log_fd_ >= 0;
       }
     }
     return false;
   }
 
   /**
-   * @brief Write logged bytes to file
+   * @brief Write logged bytes to file, waiting for a write in progress.
    */  
   bool write() {
-    {
-      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
-      std::lock_guard<std::recursive_mutex> lk1(io_mutex);
-      if (logging_enabled_) {
-	if (logs_to_file_) {
-	  log_stream_ << log_content_;
-	  log_stream_.flush();
-	} else {
-	  printf("%s", log_content_.c_str());
-	}
-	log_content_ = "";
-	return true;
-      } else {
-	log_content_ = "";
-	return false;
-      }
-    }
+    return write_buffer(true);
   }
 
   /**
    * @brief Flush out to file.
+   *
+   * Skipped while another thread is writing this log out; the buffer is
+   * flushed by a later call instead of blocking the caller.
    */  
   bool flush() {
     {
       std::lock_guard<std::recursive_mutex> lk(settings_mutex);
-      if (is_periodic_ && size() > max_log_unit_) {
-	write();
-	return true;
-      }
+      if (!is_periodic_ || size() <= max_log_unit_)
+	return false;
     }
-    return false;
+    return write_buffer(false);
   }
 
   /**
@@ -172,19 +235,26 @@ public:
   bool log(std::string log_level, const char * format, ...) {
     {
       std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
-      std::lock_guard<std::recursive_mutex> lk1(io_mutex);
-      if (logging_enabled_) {
-	va_list args;
-	va_start (args, format);
-	char log_entry[1024];
-	vsprintf (log_entry, format, args);
-	std::string log_entry_string(log_entry);
-	va_end (args);
-	log_content_ += "ROSMOD::" + log_level  + "::" + clock() + 
-	  "::" + log_entry_string + "\n";
-	flush();
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
+      if (!logging_enabled_)
+	return false;
+      va_list args;
+      va_start (args, format);
+      char log_entry[1024];
+      vsnprintf (log_entry, sizeof(log_entry), format, args);
+      va_end (args);
+      if (format_ == StructuredLog::text) {
+	char time[24];
+	snprintf(time, sizeof(time), "%lld",
+		 static_cast<long long>(clock_.now().time_since_epoch().count()));
+	log_content_.append("ROSMOD::").append(log_level).append("::").append(time)
+	  .append("::").append(log_entry).append("\n");
+      } else {
+	append_record(log_level, log_entry, {});
       }
     }
+    flush();
+    return true;
   }
 
   /**
@@ -194,18 +264,43 @@ public:
   bool raw_log(const char * format, ...) {
     {
       std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
-      std::lock_guard<std::recursive_mutex> lk1(io_mutex);
-      if (logging_enabled_) {
-	va_list args;
-	va_start (args, format);
-	char log_entry[1024];
-	vsprintf (log_entry, format, args);
-	std::string log_entry_string(log_entry);
-	va_end (args);
-	log_content_ += log_entry_string + "\n";
-	flush();
-      }
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
+      if (!logging_enabled_)
+	return false;
+      va_list args;
+      va_start (args, format);
+      char log_entry[1024];
+      vsnprintf (log_entry, sizeof(log_entry), format, args);
+      va_end (args);
+      if (format_ == StructuredLog::text)
+	log_content_.append(log_entry).append("\n");
+      else
+	append_record("RAW", log_entry, {});
     }
+    flush();
+    return true;
+  }
+
+  /**
+   * @brief Log a record with typed fields, in the logger's format.
+   *
+   * @param[in] log_level string indicating logging level.
+   * @param[in] message what happened.
+   * @param[in] fields key/value fields, e.g. {{"bytes", 128}, {"topic", name}}.
+   *
+   * @detailed Text logs get ROSMOD::<log_level>::<timestamp>::<message> key=value ...
+   */
+  bool log_fields(const std::string& log_level, const std::string& message,
+		  std::initializer_list<LogField> fields) {
+    {
+      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
+      if (!logging_enabled_)
+	return false;
+      append_record(log_level, message, fields);
+    }
+    flush();
+    return true;
   }
 
   /**
@@ -213,8 +308,8 @@ public:
    */  
   int size() {
     {
-      std::lock_guard<std::recursive_mutex> lk(io_mutex);
-      return log_content_.size();
+      std::lock_guard<std::recursive_mutex> lk(buffer_mutex);
+      return log_content_.size() + columns_.size() * (format_ == StructuredLog::columnar);
     }
   }
 
@@ -222,21 +317,203 @@ public:
    * @brief Return the current clock value.
    */  
   std::string clock() {
-    std::stringstream clock_string;
-    clock_string << clock_.now().time_since_epoch().count();
-    return clock_string.str();
+    return std::to_string(clock_.now().time_since_epoch().count());
   }
 
 private:
-  std::recursive_mutex io_mutex;               /*!< Mutex for writing to the log */
+  /**
+   * @brief Write the buffer out, doing the I/O outside the buffer lock.
+   *
+   * The full buffer is swapped with the emptied one last written, under
+   * the lock, so both keep their capacity and logging threads only wait
+   * for the swap. Writes stay in order under write_mutex. The buffers go
+   * to the LogSink in one gathering write, columns and all, and with
+   * io_uring stay in flight until the next write of this logger.
+   *
+   * @param[in] wait wait for a write in progress, or give up.
+   * @return false if disabled, or if not waiting and a write is in progress.
+   */
+  bool write_buffer(bool wait) {
+    std::unique_lock<std::mutex> writing(write_mutex, std::defer_lock);
+    LogSink& sink = LogSink::instance();
+    if (wait)
+      writing.lock();
+    else if (!writing.try_lock() || !sink.done(written_))
+      return false;
+    // the last write must be done before its buffers are reused
+    sink.wait(written_);
+    writing_.clear();
+    written_columns_.clear();
+    bool to_file;
+    LogCompressor::Method compression;
+    {
+      std::lock_guard<std::recursive_mutex> lk0(settings_mutex);
+      std::lock_guard<std::recursive_mutex> lk1(buffer_mutex);
+      if (!logging_enabled_) {
+	log_content_.clear();
+	return false;
+      }
+      writing_.swap(log_content_);
+      std::swap(written_columns_, columns_);
+      to_file = logs_to_file_;
+      compression = compression_;
+    }
+    // a log file that couldn't be opened is retried, never swapped for stdout
+    if (to_file && log_fd_ < 0 && !reopen_file()) {
+      dropped_ += writing_.size() + written_columns_.size();
+      return true;
+    }
+    // columns go out as they are, unless they have to be one buffer
+    bool gather = to_file && compression == LogCompressor::none;
+    if (!gather && written_columns_.rows() > 0)
+      written_columns_.serialize(writing_);
+    iov_.clear();
+    if (!writing_.empty()) {
+      struct iovec content = {&writing_[0], writing_.size()};
+      iov_.push_back(content);
+    }
+    if (gather && written_columns_.rows() > 0)
+      written_columns_.gather(heads_, iov_);
+    size_t bytes = 0;
+    for (size_t i = 0; i < iov_.size(); i++)
+      bytes += iov_[i].iov_len;
+    ROSMOD_TRACE2(log_flush, bytes, to_file);
+    Timeline& timeline = Timeline::instance();
+    Timeline::Clock::time_point start = Timeline::Clock::now();
+    if (to_file && compression != LogCompressor::none && bytes > 0) {
+      LogCompressor::compress(compression, writing_.data(), writing_.size(), compressed_);
+      struct iovec frame = {&compressed_[0], compressed_.size()};
+      iov_.assign(1, frame);
+    }
+    if (to_file) {
+      if (!iov_.empty()) {
+	sink.write(log_fd_, iov_.data(), iov_.size(), written_, !wait);
+	segment_bytes_ += written_.size;
+      }
+      rotate_if_due();
+    } else {
+      fwrite(writing_.data(), 1, writing_.size(), stdout);
+    }
+    if (timeline.enabled())
+      timeline.span("\"log flush\"", "log", start, Timeline::Clock::now(), "bytes", bytes);
+    return true;
+  }
+
+  /**
+   * @brief Open log_path_ for appending.
+   * @param[in] quiet don't report a failure.
+   * @return the file descriptor, or -1.
+   */
+  int open_file(bool quiet = false) {
+    int fd = open(log_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0 && !quiet)
+      perror(("Couldn't open log " + log_path_).c_str());
+    return fd;
+  }
+
+  /**
+   * @brief Open log_path_ again after it failed to open.
+   * @return false if it still can't be opened.
+   */
+  bool reopen_file() {
+    // reported when it first failed
+    log_fd_ = open_file(true);
+    if (log_fd_ < 0)
+      return false;
+    if (dropped_ > 0)
+      fprintf(stderr, "Reopened log %s, %zu bytes were dropped\n", log_path_.c_str(), dropped_);
+    dropped_ = 0;
+    start_segment();
+    return true;
+  }
+
+  /**
+   * @brief The line starting a text log.
+   */
+  static const char* banner() {
+    return "=================================================================\n";
+  }
+
+  /**
+   * @brief Add a record in the json or columnar format.
+   */
+  void append_record(const std::string& log_level, const std::string& message,
+		     std::initializer_list<LogField> fields) {
+    int64_t time = clock_.now().time_since_epoch().count();
+    if (format_ == StructuredLog::json)
+      StructuredLog::append_json(log_content_, log_level, time, message, fields);
+    else if (format_ == StructuredLog::columnar)
+      columns_.append(log_level, time, message, fields);
+    else
+      StructuredLog::append_text(log_content_, log_level, clock(), message, fields);
+  }
+
+  /**
+   * @brief Start counting the file being written as the current segment.
+   */
+  void start_segment() {
+    if (segment_size_ == 0 && segment_interval_ <= 0)
+      return;
+    struct stat status;
+    segment_bytes_ = stat(log_path_.c_str(), &status) == 0 ? status.st_size : 0;
+    segment_start_ = std::chrono::steady_clock::now();
+    if (segment_ < 0)
+      segment_ = LogRotator::last_segment(log_path_);
+    if (segment_size_ > 0 && segment_bytes_ < segment_size_)
+      LogRotator::instance().preallocate(log_path_, segment_size_);
+  }
+
+  /**
+   * @brief Rotate the log file if its segment is full or old enough.
+   *
+   * Only the rename and reopen happen here; the rotator thread does the
+   * rest.
+   */
+  void rotate_if_due() {
+    if (!(segment_size_ > 0 && segment_bytes_ >= segment_size_) &&
+	!(segment_interval_ > 0 && std::chrono::steady_clock::now() - segment_start_ >=
+	  std::chrono::duration<double>(segment_interval_)))
+      return;
+    std::string segment = log_path_ + "." + std::to_string(segment_ + 1);
+    LogSink::instance().wait(written_);
+    close(log_fd_);
+    if (rename(log_path_.c_str(), segment.c_str()) == 0) {
+      segment_++;
+      LogRotator::instance().retire(segment, log_path_,
+				    keep_segments_ > 0 ? segment_ - keep_segments_ + 1 : 0);
+    } else {
+      perror(("Couldn't rotate log " + log_path_).c_str());
+    }
+    log_fd_ = open_file();
+    start_segment();
+  }
+
+  std::recursive_mutex buffer_mutex;           /*!< Mutex for the log contents */
   std::recursive_mutex settings_mutex;         /*!< Mutex for controlling the settings */
-  std::ofstream log_stream_;                   /*!< Output log stream */
+  std::mutex write_mutex;                      /*!< Mutex for writing to the log, and the fields it writes */
+  int log_fd_;                                 /*!< Log file, or -1 */
   std::string log_content_;                    /*!< Log contents */
+  std::string writing_;                        /*!< Log contents being written */
+  ColumnarLog written_columns_;                /*!< Records being written, if columnar */
+  std::string heads_;                          /*!< Column headers being written */
+  std::vector<struct iovec> iov_;              /*!< Buffers being written */
+  LogWrite written_;                           /*!< The last write */
   std::string log_path_;                       /*!< Log file path */
   bool is_periodic_;                           /*!< Is logging periodic? */
   bool logs_to_file_;                          /*!< Is logging to file? */
   bool logging_enabled_;                       /*!< Is this logger enabled? */
   int max_log_unit_;                           /*!< Maximum log unit in bytes */
+  LogCompressor::Method compression_;          /*!< Compression of the log file */
+  std::string compressed_;                     /*!< Compressed frame being written */
+  StructuredLog::Format format_;               /*!< Output format */
+  ColumnarLog columns_;                        /*!< Records not yet written, if columnar */
+  size_t segment_size_;                        /*!< Bytes per segment, or 0 */
+  double segment_interval_;                    /*!< Seconds per segment, or 0 */
+  int keep_segments_;                          /*!< Rotated segments kept, or 0 for all */
+  int segment_;                                /*!< Last segment number, -1 if unknown */
+  size_t segment_bytes_;                       /*!< Bytes in the current segment */
+  size_t dropped_;                             /*!< Bytes dropped while the file couldn't be opened */
+  std::chrono::steady_clock::time_point segment_start_; /*!< Start of the current segment */
   std::chrono::high_resolution_clock clock_;   /*!< High resolution clock */
 };
 
@@ -0,0 +1,80 @@
+/** @file    message_pool.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the pools recycling subscription messages
+ */
+
+#ifndef MESSAGE_POOL_HPP
+#define MESSAGE_POOL_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+/**
+ * @brief Type-independent part of a MessagePool, for reporting.
+ */
+class MessagePoolBase {
+public:
+  MessagePoolBase(const std::string& name) : name_(name), hits_(0), misses_(0) {}
+  virtual ~MessagePoolBase() {}
+
+  const std::string& name() const { return name_; }
+  uint64_t hits() const { return hits_; }      /*!< Messages recycled */
+  uint64_t misses() const { return misses_; }  /*!< Messages allocated */
+
+protected:
+  std::string name_;               /*!< Topic the pool serves */
+  std::atomic<uint64_t> hits_;     /*!< Messages recycled */
+  std::atomic<uint64_t> misses_;   /*!< Messages allocated */
+};
+
+/**
+ * @brief Recycles the messages roscpp deserializes for a subscription.
+ *
+ * The pool keeps a reference to up to capacity messages. A message only
+ * referenced by the pool is no longer used by anyone else, so acquire()
+ * hands it out again, and deserializing into it reuses the storage of its
+ * arrays and strings. Only when every pooled message is still in use is a
+ * new one allocated. Use acquire() as the SubscribeOptions message factory.
+ */
+template <class M>
+class MessagePool : public MessagePoolBase {
+public:
+  MessagePool(const std::string& name, size_t capacity)
+    : MessagePoolBase(name), capacity_(capacity), next_(0) {
+    messages_.reserve(capacity_);
+  }
+
+  /**
+   * @brief A message not referenced anywhere else; its contents are stale.
+   */
+  boost::shared_ptr<M> acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Messages are mostly released in order, so start after the last hit
+    for (size_t n = 0; n < messages_.size(); n++) {
+      size_t i = (next_ + n) % messages_.size();
+      if (messages_[i].use_count() == 1) {
+	next_ = i + 1;
+	hits_++;
+	return messages_[i];
+      }
+    }
+    misses_++;
+    boost::shared_ptr<M> message = boost::make_shared<M>();
+    if (messages_.size() < capacity_)
+      messages_.push_back(message);
+    return message;
+  }
+
+private:
+  size_t capacity_;                           /*!< Most messages kept */
+  std::mutex mutex_;                          /*!< Guards the fields below */
+  std::vector<boost::shared_ptr<M> > messages_; /*!< Pooled messages */
+  size_t next_;                               /*!< Where the next search starts */
+};
+
+#endif
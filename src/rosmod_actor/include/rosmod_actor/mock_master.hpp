@@ -0,0 +1,139 @@
+/** @file    mock_master.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the MockMaster class
+ */
+
+#ifndef MOCK_MASTER_HPP
+#define MOCK_MASTER_HPP
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <xmlrpcpp/XmlRpc.h>
+
+/**
+ * @brief In-process stand-in for the ROS master.
+ *
+ * Serves the master's XML-RPC API (topic, service and parameter
+ * registration and lookup) from a thread of the calling process, so
+ * roscpp and unmodified components can run without a roscore. Point
+ * roscpp at uri(), through ROS_MASTER_URI or the __master remapping,
+ * before ros::init().
+ *
+ * Publishers and subscribers in the same process are then connected by
+ * roscpp's intraprocess transport, and messages never leave the process.
+ * Subscribers are told about new publishers asynchronously, as with the
+ * real master.
+ */
+class MockMaster {
+public:
+  /**
+   * @brief A node's registration of a topic or service.
+   */
+  struct Registration {
+    std::string node;  /*!< Caller id of the node */
+    std::string api;   /*!< XML-RPC URI of the node */
+  };
+  typedef std::map<std::string, std::vector<Registration> > Registrations;
+
+  MockMaster();
+
+  /**
+   * @brief Stops the master if it is running.
+   */
+  ~MockMaster();
+
+  /**
+   * @brief Start serving.
+   * @param[in] port port to listen on; 0 picks a free one.
+   * @return false if the port couldn't be bound.
+   */
+  bool start(int port = 0);
+
+  /**
+   * @brief Stop serving. Nodes must be shut down first.
+   */
+  void stop();
+
+  /**
+   * @brief The master URI, as http://127.0.0.1:<port>/
+   */
+  const std::string& uri() const;
+
+private:
+  class Method;
+  typedef void (MockMaster::*Handler)(XmlRpc::XmlRpcValue& params,
+				      XmlRpc::XmlRpcValue& result);
+
+  /**
+   * @brief A call from the master to a node's XML-RPC API.
+   */
+  struct Notification {
+    std::string api;              /*!< XML-RPC URI of the node */
+    std::string method;           /*!< Method to call */
+    XmlRpc::XmlRpcValue params;   /*!< Its arguments */
+  };
+
+  void serve();
+  void notify();
+  void enqueue(const std::string& api, const std::string& method,
+	       const XmlRpc::XmlRpcValue& params);
+  void update_subscribers(const std::string& topic);
+  void update_param_subscribers(const std::string& key);
+
+  bool get_param(const std::string& key, XmlRpc::XmlRpcValue& value) const;
+  bool has_param(const std::string& key) const;
+  void set_param(const std::string& key, XmlRpc::XmlRpcValue& value);
+  void erase_param(const std::string& key);
+
+  // Master API, see http://wiki.ros.org/ROS/Master_API
+  void register_publisher(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void unregister_publisher(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void register_subscriber(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void unregister_subscriber(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void register_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void unregister_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void lookup_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void lookup_node(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_published_topics(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_topic_types(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_system_state(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_uri(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_pid(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+
+  // Parameter server API, see http://wiki.ros.org/ROS/Parameter%20Server%20API
+  void get_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void set_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void has_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void delete_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void search_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void subscribe_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void unsubscribe_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+  void get_param_names(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result);
+
+  XmlRpc::XmlRpcServer server_;                 /*!< Serves the master API */
+  std::vector<std::unique_ptr<Method> > methods_; /*!< Methods added to server_ */
+  std::string uri_;                             /*!< Master URI */
+  std::atomic<bool> running_;                   /*!< Keep serving? */
+  boost::thread* server_thread_;                /*!< Runs serve() */
+  boost::thread* notify_thread_;                /*!< Runs notify() */
+
+  // Only used on the server thread
+  Registrations publishers_;                    /*!< Publishers by topic */
+  Registrations subscribers_;                   /*!< Subscribers by topic */
+  Registrations param_subscribers_;             /*!< Parameter subscribers by key */
+  std::map<std::string, std::string> topic_types_;  /*!< Message type by topic */
+  std::map<std::string, std::string> nodes_;    /*!< XML-RPC URI by caller id */
+  std::map<std::string, std::pair<std::string, Registration> > services_; /*!< Service URI and provider by service */
+  std::map<std::string, XmlRpc::XmlRpcValue> params_; /*!< Parameter leaves by full name */
+
+  boost::mutex notify_mutex_;                   /*!< Guards notifications_ */
+  boost::condition_variable notify_cond_;       /*!< Signals notifications_ */
+  std::deque<Notification> notifications_;      /*!< Pending calls to nodes */
+};
+
+#endif
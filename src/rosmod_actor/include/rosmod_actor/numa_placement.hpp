@@ -0,0 +1,109 @@
+/** @file    numa_placement.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the NUMA placement of component instances
+ */
+
+#ifndef NUMA_PLACEMENT_HPP
+#define NUMA_PLACEMENT_HPP
+
+#include <string>
+#include <vector>
+#include <sched.h>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief A NUMA node the actor may run on.
+ */
+struct NumaNode {
+  int id;                 /*!< Node number */
+  cpu_set_t cpus;         /*!< Its CPUs in the actor's affinity mask */
+  unsigned int instances; /*!< Instances placed on it */
+};
+
+/**
+ * @brief A thread's memory policy, saved to be restored later.
+ */
+struct MemoryPolicy {
+  static const int kMaxNodes = 1024;
+
+  int mode;                                                   /*!< MPOL_* mode and flags */
+  unsigned long nodes[kMaxNodes / (8 * sizeof(unsigned long))]; /*!< Its node mask */
+};
+
+/**
+ * @brief Places component instances on NUMA nodes.
+ *
+ * An instance with a "NUMA Node" is placed on that node. With "NUMA
+ * Placement": "Auto" in the deployment configuration, the others are spread
+ * over the nodes with CPUs in the actor's affinity mask, each going to the
+ * node with the fewest instances. A placed instance is constructed with
+ * memory preferred from its node, and its thread runs on the node's CPUs
+ * with the same memory preference, so the component queue, logger buffers
+ * and message pools it allocates are node-local.
+ *
+ * Nodes are read from sysfs. Automatic placement is skipped on machines
+ * with a single node.
+ */
+class NumaPlacement {
+public:
+  NumaPlacement();
+
+  /**
+   * @brief Discover the nodes and read the placement mode.
+   * @param[in] config deployment configuration.
+   */
+  void configure(const Json::Value& config);
+
+  /**
+   * @brief Choose the node of an instance and count it there.
+   * @param[in] instance the instance's entry in "Component Instances".
+   * @return the node, or -1 to leave the instance unplaced.
+   */
+  int place(const Json::Value& instance);
+
+  /**
+   * @brief Uncount an instance placed by place().
+   */
+  void release(int node);
+
+  /**
+   * @brief Log each node's CPUs, free memory and instances.
+   */
+  void report() const;
+
+  /**
+   * @brief Prefer memory from a node for the calling thread's allocations.
+   * @param[in] node node; -1 leaves the policy as it is, e.g. inherited
+   *            from numactl --membind.
+   * @return false if the policy couldn't be set.
+   */
+  static bool prefer_memory(int node);
+
+  /**
+   * @brief Save the calling thread's memory policy.
+   * @param[out] policy the policy.
+   * @return false if it couldn't be read.
+   */
+  static bool save_memory(MemoryPolicy& policy);
+
+  /**
+   * @brief Give the calling thread a policy saved by save_memory().
+   * @return false if the policy couldn't be set.
+   */
+  static bool restore_memory(const MemoryPolicy& policy);
+
+  /**
+   * @brief Run the calling thread on a node's CPUs, with memory from it.
+   * @param[in] node node chosen by place(); -1 does nothing.
+   * @return false if the thread couldn't be bound.
+   */
+  bool bind_thread(int node) const;
+
+private:
+  int find(int node) const;
+
+  std::vector<NumaNode> nodes_;  /*!< Nodes with CPUs the actor may use */
+  bool automatic_;               /*!< Place instances without a "NUMA Node"? */
+};
+
+#endif
@@ -0,0 +1,89 @@
+/** @file    realtime_memory.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the actor's real-time memory mode
+ */
+
+#ifndef REALTIME_MEMORY_HPP
+#define REALTIME_MEMORY_HPP
+
+#include <stddef.h>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief Page faults taken by a thread.
+ */
+struct PageFaults {
+  long minor;  /*!< Faults served without I/O */
+  long major;  /*!< Faults that needed I/O */
+};
+
+/**
+ * @brief Stack of a thread.
+ */
+struct StackUsage {
+  size_t size;      /*!< Usable stack size */
+  size_t guard;     /*!< Guard size below it */
+  size_t resident;  /*!< Stack pages in memory */
+};
+
+/**
+ * @brief Keeps page faults out of component callbacks.
+ *
+ * Enabled by a "Real-Time Memory" object in the deployment configuration:
+ *
+ *   "Real-Time Memory": { "Stack Size": 1048576, "Heap Reserve": 8388608 }
+ *
+ * lock() locks the actor's current and future memory and stops the heap
+ * from being trimmed or served by mmap(), so freed memory is kept for
+ * reuse. Each component thread is created with a "Stack Size" stack and
+ * calls prepare_thread() before its startUp(), which touches the stack and
+ * a "Heap Reserve" of heap in the thread's malloc arena.
+ */
+class RealtimeMemory {
+public:
+  RealtimeMemory();
+
+  /**
+   * @brief Read the mode from the deployment configuration.
+   */
+  void configure(const Json::Value& config);
+
+  /**
+   * @brief Is the mode enabled?
+   */
+  bool enabled() const;
+
+  /**
+   * @brief Stack size of component threads without a "Stack Size" of their
+   *        own, or 0 for the system default.
+   */
+  size_t stack_size() const;
+
+  /**
+   * @brief Lock memory and configure malloc; call before starting threads.
+   * @return false if memory couldn't be locked.
+   */
+  bool lock() const;
+
+  /**
+   * @brief Fault in the calling thread's stack and heap reserve.
+   */
+  void prepare_thread() const;
+
+  /**
+   * @brief Page faults taken by the calling thread so far.
+   */
+  static PageFaults thread_faults();
+
+  /**
+   * @brief Size and resident part of the calling thread's stack.
+   */
+  static StackUsage thread_stack();
+
+private:
+  bool enabled_;         /*!< Is the mode enabled? */
+  size_t stack_size_;    /*!< "Stack Size" of component threads */
+  size_t heap_reserve_;  /*!< "Heap Reserve" faulted in per component thread */
+};
+
+#endif
@@ -0,0 +1,82 @@
+/** @file    replay.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the replay log and statistics classes
+ */
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief A recorded callback event.
+ */
+struct ReplayEvent {
+  enum Kind {
+    message = 0,  /*!< A message received on a topic */
+    timer = 1     /*!< A timer expiring */
+  };
+
+  uint64_t stamp;                /*!< Recorded ROS time in nanoseconds */
+  Kind kind;                     /*!< What kind of callback this drives */
+  std::string component;         /*!< Target instance "Name", empty for all */
+  std::string channel;           /*!< Topic or timer name */
+  std::vector<uint8_t> payload;  /*!< Serialized message, empty for timers */
+};
+
+/**
+ * @brief Reads and writes replay logs.
+ *
+ * A replay log starts with the 8 byte magic "RMODRPL1" followed by the
+ * events, with all integers little-endian:
+ *
+ *   u64 stamp, u8 kind,
+ *   u32 length + bytes of component, channel and payload each
+ *
+ * Events need not be in stamp order; they are sorted on load.
+ */
+class ReplayLog {
+public:
+  /**
+   * @brief Load all events of a replay log, sorted by stamp.
+   * @param[in] path path to the replay log.
+   * @param[out] events receives the events.
+   * @return false if the file can't be read or is malformed.
+   */
+  static bool read(const std::string& path, std::vector<ReplayEvent>& events);
+
+  /**
+   * @brief Start a replay log.
+   * @param[in] out stream to write to; should be opened in binary mode.
+   */
+  static bool write_header(std::ostream& out);
+
+  /**
+   * @brief Append an event to a replay log.
+   * @param[in] out stream the header was written to.
+   * @param[in] event event to append.
+   */
+  static bool write(std::ostream& out, const ReplayEvent& event);
+};
+
+/**
+ * @brief Timings of the replayed events of one channel.
+ */
+struct ReplayStats {
+  ReplayStats() : unhandled(0) {}
+
+  /**
+   * @brief Summarize the timings as count and distribution in microseconds.
+   */
+  Json::Value summary() const;
+
+  std::vector<double> execution_us;  /*!< Time spent in the handler */
+  std::vector<double> delay_us;      /*!< Scheduled time to handler start */
+  unsigned int unhandled;            /*!< Events with no handler registered */
+};
+
+#endif
@@ -0,0 +1,165 @@
+/** @file    structured_log.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the structured log fields and formats
+ */
+
+#ifndef STRUCTURED_LOG_HPP
+#define STRUCTURED_LOG_HPP
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+/**
+ * @brief A typed key/value field of a structured log record.
+ *
+ * The key is not copied; it must outlive the logging call, as a literal
+ * does.
+ */
+struct LogField {
+  enum Type {
+    integer = 0,  /*!< int64 */
+    real = 1,     /*!< double */
+    boolean = 2,  /*!< bool */
+    text = 3      /*!< UTF-8 string */
+  };
+
+  LogField(const char* key, int value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, long value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, long long value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, unsigned value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, unsigned long value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, unsigned long long value) : key(key), type(integer), number(value) {}
+  LogField(const char* key, double value) : key(key), type(real), real_number(value) {}
+  LogField(const char* key, bool value) : key(key), type(boolean), number(value) {}
+  LogField(const char* key, const char* value) : key(key), type(text), string(value) {}
+  LogField(const char* key, const std::string& value) : key(key), type(text), string(value) {}
+
+  const char* key;     /*!< Field name */
+  Type type;           /*!< Type of the value */
+  int64_t number;      /*!< integer or boolean value */
+  double real_number;  /*!< real value */
+  std::string string;  /*!< text value */
+};
+
+/**
+ * @brief Output formats of a Logger and their encoders.
+ *
+ * Every record has a time (the logger's clock), a level and a message,
+ * then its own fields:
+ *
+ *   text      ROSMOD::<level>::<time>::<message> key=value ...
+ *   json      {"time":<time>,"level":"<level>","message":"<message>","key":value,...}
+ *   columnar  blocks of ColumnarLog
+ */
+class StructuredLog {
+public:
+  enum Format {
+    text = 0,     /*!< The original ROSMOD lines */
+    json = 1,     /*!< One JSON object per line */
+    columnar = 2  /*!< Binary column blocks */
+  };
+
+  /**
+   * @brief Parse a "Format" setting: "Text", "JSON" or "Columnar".
+   * @param[in] name setting to parse.
+   * @param[out] format the format to use.
+   * @return false if name is none of these.
+   */
+  static bool parse(const std::string& name, Format& format);
+
+  /**
+   * @brief Append a record as a text line.
+   */
+  static void append_text(std::string& out, const std::string& level, const std::string& time,
+			  const std::string& message, std::initializer_list<LogField> fields);
+
+  /**
+   * @brief Append a record as a JSON line.
+   */
+  static void append_json(std::string& out, const std::string& level, int64_t time,
+			  const std::string& message, std::initializer_list<LogField> fields);
+};
+
+/**
+ * @brief Builds records into columns, written out as one block per flush.
+ *
+ * A block is
+ *
+ *   "RMODLOG1", uint32 rows, uint32 columns, then per column:
+ *   uint16 name length, name, uint8 LogField::Type, a presence bitmap of
+ *   (rows + 7) / 8 bytes (bit i of byte i / 8, LSB first, set if row i
+ *   has the field), then the values of the rows present: int64 or
+ *   double, uint8 for boolean, uint32 length and bytes for text.
+ *
+ * All integers are little-endian. The first columns are "time",
+ * "level" and "message". A key logged with different types gets a
+ * column per type. scripts/read_columnar_log.py reads the blocks back.
+ */
+class ColumnarLog {
+public:
+  ColumnarLog();
+
+  /**
+   * @brief Add a record.
+   */
+  void append(const std::string& level, int64_t time, const std::string& message,
+	      std::initializer_list<LogField> fields);
+
+  /**
+   * @brief Size of the encoded block in bytes.
+   */
+  size_t size() const {
+    return bytes_;
+  }
+
+  /**
+   * @brief Number of records added.
+   */
+  size_t rows() const {
+    return rows_;
+  }
+
+  /**
+   * @brief Append the block to out and start a new one, reusing capacity.
+   */
+  void serialize(std::string& out);
+
+  /**
+   * @brief Describe the block as buffers for writev, without copying it.
+   *
+   * The buffers point into this log and into heads, so neither may change
+   * until they are written; clear() then starts a new block.
+   * @param[out] heads receives the block and column headers.
+   * @param[out] iov buffers appended, in order.
+   */
+  void gather(std::string& heads, std::vector<struct iovec>& iov);
+
+  /**
+   * @brief Start a new block, reusing capacity.
+   */
+  void clear();
+
+private:
+  /**
+   * @brief One column of the block.
+   */
+  struct Column {
+    std::string name;              /*!< Field name */
+    LogField::Type type;           /*!< Type of the values */
+    std::vector<uint8_t> present;  /*!< Presence bitmap */
+    std::string values;            /*!< Encoded values of the rows present */
+  };
+
+  Column& column(const char* name, LogField::Type type);
+  void add(size_t row, const LogField& field);
+
+  std::vector<Column> columns_;  /*!< Columns seen so far, kept for their capacity */
+  size_t rows_;                  /*!< Rows in the current block */
+  size_t bytes_;                 /*!< Encoded size of the current block */
+};
+
+#endif
@@ -0,0 +1,139 @@
+/** @file    timeline.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the actor's execution timeline recorder
+ */
+
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "rosmod_actor/json.hpp"
+
+/**
+ * @brief An event on the timeline.
+ */
+struct TimelineEvent {
+  const char* name;      /*!< Interned, quoted name */
+  const char* category;  /*!< Category, a literal */
+  char phase;            /*!< 'X' for a span, 'i' for an instant */
+  int64_t start_ns;      /*!< steady_clock time */
+  int64_t duration_ns;   /*!< Span duration */
+  const char* arg_name;  /*!< Name of arg, a literal, or NULL */
+  int64_t arg;           /*!< Event argument */
+};
+
+/**
+ * @brief Records what every actor thread does, for chrome://tracing or
+ *        Perfetto.
+ *
+ * Enabled by a "Timeline" object in the deployment configuration:
+ *
+ *   "Timeline": { "File": "timeline.json", "Events Per Thread": 65536 }
+ *
+ * Each thread records into its own ring buffer, keeping its last "Events
+ * Per Thread" events, so recording takes an uncontended lock. A ring only
+ * grows as events are recorded. The rings of the last 64 threads to exit
+ * are kept and older ones freed, so memory stays bounded while tracing is
+ * left on, even as reloads start new threads. write() exports all buffers
+ * as a Chrome Trace Event file when the actor shuts down.
+ */
+class Timeline {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief The actor's timeline.
+   */
+  static Timeline& instance();
+
+  /**
+   * @brief Read the "Timeline" settings; call before starting threads.
+   */
+  void configure(const Json::Value& config);
+
+  /**
+   * @brief Is recording enabled?
+   */
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief A stable copy of a name for recording; not for hot paths.
+   */
+  const char* intern(const std::string& name);
+
+  /**
+   * @brief Name the calling thread on the timeline.
+   */
+  void name_thread(const std::string& name);
+
+  /**
+   * @brief Record a span on the calling thread.
+   * @param[in] name interned name.
+   * @param[in] category category literal.
+   * @param[in] start start of the span.
+   * @param[in] end end of the span.
+   * @param[in] arg_name name of arg, a literal, or NULL for none.
+   * @param[in] arg event argument.
+   */
+  void span(const char* name, const char* category, Clock::time_point start,
+	    Clock::time_point end, const char* arg_name = NULL, int64_t arg = 0);
+
+  /**
+   * @brief Record an instant on the calling thread.
+   * @see span()
+   */
+  void instant(const char* name, const char* category, Clock::time_point time,
+	       const char* arg_name = NULL, int64_t arg = 0);
+
+  /**
+   * @brief Write all recorded events to the configured "File".
+   * @return false if the file couldn't be written.
+   */
+  bool write();
+
+private:
+  /**
+   * @brief Events of one thread, the last capacity of them kept.
+   */
+  struct ThreadBuffer {
+    std::mutex mutex;                  /*!< Taken by the thread and by write() */
+    long tid;                          /*!< Kernel thread id */
+    std::string name;                  /*!< Quoted thread name */
+    std::vector<TimelineEvent> events; /*!< Ring of events, grown up to capacity_ */
+    uint64_t recorded;                 /*!< Events ever recorded */
+    bool exited;                       /*!< Has the thread exited? */
+  };
+
+  /**
+   * @brief Hands a thread's buffer back when the thread exits.
+   */
+  struct ThreadExit {
+    ~ThreadExit();
+    ThreadBuffer** local;              /*!< The thread's buffer pointer */
+  };
+
+  Timeline();
+
+  ThreadBuffer& buffer();
+  void record(const TimelineEvent& event);
+  void release(ThreadBuffer* buffer);
+
+  std::atomic<bool> enabled_;                          /*!< Is recording enabled? */
+  std::string path_;                                   /*!< "File" */
+  size_t capacity_;                                    /*!< "Events Per Thread" */
+  std::mutex mutex_;                                   /*!< Guards the fields below */
+  std::vector<std::shared_ptr<ThreadBuffer> > buffers_; /*!< Live and recently exited threads' buffers */
+  uint64_t freed_;                                     /*!< Events in the buffers freed */
+  std::set<std::string> names_;                        /*!< Interned names */
+};
+
+#endif
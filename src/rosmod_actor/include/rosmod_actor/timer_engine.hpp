@@ -0,0 +1,170 @@
+/** @file    timer_engine.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the actor's periodic timer engine
+ */
+
+#ifndef TIMER_ENGINE_HPP
+#define TIMER_ENGINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <stdint.h>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include "rosmod_actor/json.hpp"
+#include "rosmod_actor/timeline.hpp"
+
+#include "ros/ros.h"
+#include "ros/callback_queue.h"
+
+/**
+ * @brief Lateness of a timer's callbacks.
+ *
+ * Lateness is measured from the scheduled expiry to the start of the
+ * callback, so it includes both the timer wakeup and the wait in the
+ * component queue.
+ */
+struct TimerStats {
+  static const int kBuckets = 32;
+
+  TimerStats();
+
+  /**
+   * @brief Add a callback's lateness.
+   */
+  void record(double lateness_us);
+
+  /**
+   * @brief Summarize as counts, lateness distribution and histogram.
+   */
+  Json::Value summary() const;
+
+  uint64_t histogram[kBuckets];   /*!< Bucket 0 counts lateness below 1 us, bucket i in [2^(i-1), 2^i) us */
+  uint64_t count;                 /*!< Callbacks run */
+  double sum_us;                  /*!< Total lateness */
+  double min_us;                  /*!< Smallest lateness */
+  double max_us;                  /*!< Largest lateness */
+  double last_us;                 /*!< Lateness of the latest callback */
+  std::atomic<uint64_t> overruns; /*!< Expiries skipped because the engine fell a period behind */
+};
+
+/**
+ * @brief A timer scheduled on the TimerEngine.
+ */
+struct PeriodicTimer {
+  typedef boost::function<void(const ros::TimerEvent&)> Callback;
+
+  std::string name;                                /*!< Name in statistics */
+  const char* timeline_name;                       /*!< Name on the Timeline */
+  std::chrono::nanoseconds period;                 /*!< Period */
+  std::chrono::steady_clock::time_point start;     /*!< Expiry n is at start + n * period */
+  uint64_t next;                                   /*!< Index of the next expiry */
+  Callback callback;                               /*!< Run from the component queue */
+  ros::CallbackQueueInterface* queue;              /*!< Component queue */
+  uint64_t owner_id;                               /*!< Owner id of the queued callbacks */
+  std::atomic<bool> cancelled;                     /*!< Set by TimerEngine::cancel() */
+  bool once;                                       /*!< Expires only when set by TimerEngine::expire_in() */
+  ros::Time ros_start;                             /*!< ROS time at start */
+  ros::Time last_expected;                         /*!< Expected ROS time of the previous callback */
+  ros::Time last_real;                             /*!< ROS time of the previous callback */
+  TimerStats stats;                                /*!< Callback lateness */
+};
+typedef std::shared_ptr<PeriodicTimer> PeriodicTimerPtr;
+
+/**
+ * @brief Actor-wide engine firing periodic timers into component queues.
+ *
+ * One thread waits on a timerfd armed at the earliest absolute expiry and
+ * adds each due timer's callback to its component queue. Expiries are
+ * computed from the timer's start, never from the previous firing, so
+ * wakeup and dispatch delays don't accumulate into drift. If the engine
+ * falls more than a period behind, the missed expiries are skipped and
+ * counted as overruns instead of firing in a burst. One-shot timers from
+ * add_once() share the thread, and only expire as set by expire_in().
+ */
+class TimerEngine {
+public:
+  /**
+   * @brief The actor's timer engine; its thread starts with the first timer.
+   */
+  static TimerEngine& instance();
+
+  /**
+   * @brief Schedule a periodic timer, first expiring one period from now.
+   * @param[in] name name used in statistics.
+   * @param[in] period timer period.
+   * @param[in] callback run from the queue on each expiry.
+   * @param[in] queue component queue to add callbacks to.
+   * @param[in] owner_id owner id of the added callbacks.
+   */
+  PeriodicTimerPtr add(const std::string& name, std::chrono::nanoseconds period,
+		       const PeriodicTimer::Callback& callback,
+		       ros::CallbackQueueInterface* queue, uint64_t owner_id);
+
+  /**
+   * @brief Create a one-shot timer, which expires only when set with expire_in().
+   * @param[in] name name used in statistics.
+   * @param[in] callback run from the queue on each expiry.
+   * @param[in] queue component queue to add callbacks to.
+   * @param[in] owner_id owner id of the added callbacks.
+   */
+  PeriodicTimerPtr add_once(const std::string& name, const PeriodicTimer::Callback& callback,
+			    ros::CallbackQueueInterface* queue, uint64_t owner_id);
+
+  /**
+   * @brief Set a one-shot timer to expire once, delay from now, replacing
+   *        any expiry still ahead.
+   */
+  void expire_in(const PeriodicTimerPtr& timer, std::chrono::nanoseconds delay);
+
+  /**
+   * @brief Unset a one-shot timer. Unlike cancel(), it can be set again;
+   *        a callback already queued still runs.
+   */
+  void disarm(const PeriodicTimerPtr& timer);
+
+  /**
+   * @brief Stop a timer. No callbacks are queued once this returns, and
+   *        already queued ones are skipped.
+   */
+  void cancel(const PeriodicTimerPtr& timer);
+
+  /**
+   * @brief Enable or disable all timers; enabled by default.
+   *
+   * No callbacks are queued while disabled. Expiries missed meanwhile are
+   * counted as overruns once enabled again.
+   */
+  void set_enabled(bool enabled);
+
+  /**
+   * @brief Stop the engine thread. Timers still scheduled never fire again.
+   */
+  void stop();
+
+private:
+  typedef std::multimap<std::chrono::steady_clock::time_point, PeriodicTimerPtr> Schedule;
+
+  TimerEngine();
+  ~TimerEngine();
+
+  bool start();
+  void run();
+  void arm();
+  void wake();
+  void fire(std::chrono::steady_clock::time_point now);
+  bool unschedule(const PeriodicTimerPtr& timer);
+
+  boost::mutex mutex_;          /*!< Guards the fields below */
+  Schedule schedule_;           /*!< Timers by next expiry */
+  bool enabled_;                /*!< Do timers expire? */
+  bool running_;                /*!< Keep running? */
+  int timer_fd_;                /*!< timerfd armed at the earliest expiry */
+  int wake_fd_;                 /*!< eventfd waking the thread */
+  boost::thread* thread_;       /*!< Runs run() */
+};
+
+#endif
@@ -0,0 +1,35 @@
+/** @file    traced_callback_queue.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the component queue firing the queue tracepoints
+ */
+
+#ifndef TRACED_CALLBACK_QUEUE_HPP
+#define TRACED_CALLBACK_QUEUE_HPP
+
+#include <string>
+#include <stdint.h>
+
+#include "ros/ros.h"
+#include "ros/callback_queue.h"
+
+/**
+ * @brief Component queue firing the callback_enqueue and dispatch probes.
+ *
+ * Callbacks are only wrapped to fire the dispatch probes while a tracer is
+ * attached to one of them, or to record them while the Timeline is
+ * enabled; otherwise this is a plain ros::CallbackQueue.
+ */
+class TracedCallbackQueue : public ros::CallbackQueue {
+public:
+  /**
+   * @brief Set the component name passed to the probes.
+   */
+  void set_name(const std::string& name);
+
+  virtual void addCallback(const ros::CallbackInterfacePtr& callback, uint64_t owner_id = 0);
+
+private:
+  std::string name_;  /*!< Component name */
+};
+
+#endif
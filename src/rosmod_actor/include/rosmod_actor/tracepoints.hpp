@@ -0,0 +1,34 @@
+/** @file    tracepoints.hpp
+ *  @date    October 2026
+ *  @brief   This file declares the actor's static tracepoints
+ */
+
+#ifndef TRACEPOINTS_HPP
+#define TRACEPOINTS_HPP
+
+/*
+ * USDT probes of the rosmod_actor provider, for perf, bpftrace or
+ * SystemTap. Each is a single nop until a tracer attaches. They are built
+ * when sys/sdt.h is found (ROSMOD_ACTOR_USDT), and compile to nothing
+ * otherwise.
+ *
+ *   component_load(name, component)   component constructed
+ *   startup_begin(name)               startUp() called
+ *   startup_end(name)                 startUp() returned
+ *   callback_enqueue(name, callback)  callback added to a component queue
+ *   dispatch_begin(name, callback)    component thread calls a callback
+ *   dispatch_end(name, callback)      callback returned
+ *   log_flush(bytes, to_file)         a logger writes out its buffer
+ *   shutdown_begin(instances)         actor shutdown starts
+ *   shutdown_end(clean)               actor shutdown done
+ */
+#ifdef ROSMOD_ACTOR_USDT
+#include <sys/sdt.h>
+#define ROSMOD_TRACE1(name, a) DTRACE_PROBE1(rosmod_actor, name, a)
+#define ROSMOD_TRACE2(name, a, b) DTRACE_PROBE2(rosmod_actor, name, a, b)
+#else
+#define ROSMOD_TRACE1(name, a) do {} while (0)
+#define ROSMOD_TRACE2(name, a, b) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+"""Convert the messages of a rosbag into a rosmod_actor replay log.
+
+Usage: bag_to_replay.py <bag> <replay log> [--component NAME] [topic ...]
+
+Messages are written as they were serialized in the bag, addressed to
+all components (or only NAME), on all topics or the ones given.
+"""
+
+import argparse
+import struct
+
+import rosbag
+
+MAGIC = b'RMODRPL1'
+KIND_MESSAGE = 0
+
+
+def put_bytes(out, data):
+    out.write(struct.pack('<I', len(data)))
+    out.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('bag')
+    parser.add_argument('log')
+    parser.add_argument('--component', default='')
+    parser.add_argument('topics', nargs='*')
+    args = parser.parse_args()
+
+    count = 0
+    with rosbag.Bag(args.bag) as bag, open(args.log, 'wb') as out:
+        out.write(MAGIC)
+        for topic, msg, stamp in bag.read_messages(topics=args.topics or None,
+                                                   raw=True):
+            out.write(struct.pack('<QB', stamp.to_nsec(), KIND_MESSAGE))
+            put_bytes(out, args.component.encode('utf-8'))
+            put_bytes(out, topic.encode('utf-8'))
+            put_bytes(out, msg[1])
+            count += 1
+    print('wrote %d events to %s' % (count, args.log))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python
+"""Read a rosmod_actor columnar log and print its records as JSON lines.
+
+Usage: read_columnar_log.py <log> [--columns NAME ...] [--summary]
+
+Decompress an LZ4 or zstd log first (lz4cat, zstdcat). --columns prints
+only the named fields; --summary prints the row count and type of each
+column instead. rows() and columns() can be imported for analysis without
+any text parsing.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'RMODLOG1'
+INTEGER, REAL, BOOLEAN, TEXT = range(4)
+TYPE_NAMES = ['integer', 'real', 'boolean', 'text']
+
+
+def read_values(data, p, kind, count):
+    values = []
+    for _ in range(count):
+        if kind == INTEGER:
+            values.append(struct.unpack_from('<q', data, p)[0])
+            p += 8
+        elif kind == REAL:
+            values.append(struct.unpack_from('<d', data, p)[0])
+            p += 8
+        elif kind == BOOLEAN:
+            values.append(data[p] != 0)
+            p += 1
+        else:
+            size, = struct.unpack_from('<I', data, p)
+            values.append(data[p + 4:p + 4 + size].decode('utf-8', 'replace'))
+            p += 4 + size
+    return values, p
+
+
+def columns(data):
+    """Yield each block as (rows, [(name, type, [value or None per row])])."""
+    p = 0
+    while p < len(data):
+        if data[p:p + 8] != MAGIC:
+            raise ValueError('no block at offset %d' % p)
+        rows, count = struct.unpack_from('<II', data, p + 8)
+        p += 16
+        block = []
+        for _ in range(count):
+            size, = struct.unpack_from('<H', data, p)
+            name = data[p + 2:p + 2 + size].decode('utf-8')
+            kind = data[p + 2 + size]
+            p += 3 + size
+            bitmap = data[p:p + (rows + 7) // 8]
+            p += len(bitmap)
+            present = [bool(bitmap[i // 8] >> (i % 8) & 1) for i in range(rows)]
+            values, p = read_values(data, p, kind, sum(present))
+            it = iter(values)
+            block.append((name, kind, [next(it) if has else None for has in present]))
+        yield rows, block
+
+
+def rows(data):
+    """Yield each record as a dict of its fields."""
+    for count, block in columns(data):
+        for i in range(count):
+            yield dict((name, values[i]) for name, kind, values in block
+                       if values[i] is not None)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('log')
+    parser.add_argument('--columns', nargs='*')
+    parser.add_argument('--summary', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.log, 'rb') as log:
+        data = bytearray(log.read())
+    if args.summary:
+        total = 0
+        kinds = {}
+        for count, block in columns(data):
+            total += count
+            for name, kind, values in block:
+                kinds.setdefault((name, kind), 0)
+                kinds[(name, kind)] += sum(v is not None for v in values)
+        print('%d records' % total)
+        for (name, kind), present in sorted(kinds.items()):
+            print('%-24s %-8s %d' % (name, TYPE_NAMES[kind], present))
+        return
+    for record in rows(data):
+        if args.columns:
+            record = dict((k, v) for k, v in record.items() if k in args.columns)
+        sys.stdout.write(json.dumps(record) + '\n')
+
+
+if __name__ == '__main__':
+    main()
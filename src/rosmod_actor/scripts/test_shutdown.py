@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+"""Check that rosmod_actor shuts down cleanly on SIGINT and SIGTERM.
+
+Usage: test_shutdown.py <rosmod_actor> <shutdown test component> [--timeout SECONDS]
+
+The component library is the rosmod_actor_shutdown_test target. Each case
+starts the actor with --mock-master and two test components, signals it
+once they have logged a few ticks, then checks its exit status, the
+"Shutdown took" stage timings and that every component's buffered ticks
+reached its log file. In the last case one component is stuck in a
+callback, so the join stage must wait out the deadline and the actor must
+exit with a failure status, still flushing both logs.
+"""
+
+import argparse
+import json
+import os
+import re
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+STAGES = re.compile(r'Shutdown took ([\d.]+) ms \(stop ([\d.]+) ms, '
+                    r'join ([\d.]+) ms, flush ([\d.]+) ms\)')
+TICK = re.compile(r'::tick (\d+)$')
+
+
+def write_config(path, library, stuck):
+    instances = []
+    for name, is_stuck in (('steady', False), ('stuck', stuck)):
+        instances.append({'Name': name, 'Definition': library, 'Stuck': is_stuck})
+    with open(path, 'w') as config:
+        json.dump({'Name': 'shutdown_test', 'Priority': -1,
+                   'Component Instances': instances}, config)
+
+
+def wait_for(path, pattern, count, timeout):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        with open(path) as output:
+            if output.read().count(pattern) >= count:
+                return True
+        time.sleep(0.05)
+    return False
+
+
+def check_log(path, errors):
+    """Check that a component log has its ticks, numbered 1, 2, ... without gaps."""
+    if not os.path.exists(path):
+        errors.append('%s was not written' % os.path.basename(path))
+        return
+    with open(path) as log:
+        ticks = [int(m.group(1)) for m in map(TICK.search, log.read().splitlines()) if m]
+    if not ticks:
+        errors.append('%s has no ticks' % os.path.basename(path))
+    elif ticks != list(range(1, len(ticks) + 1)):
+        errors.append('%s lost ticks' % os.path.basename(path))
+
+
+def run_case(actor, library, sig, stuck, timeout):
+    """Run one case; returns a list of failures."""
+    directory = tempfile.mkdtemp(prefix='rosmod_shutdown_')
+    try:
+        config = os.path.join(directory, 'deployment.json')
+        output_path = os.path.join(directory, 'actor.out')
+        write_config(config, library, stuck)
+        with open(output_path, 'w') as output:
+            process = subprocess.Popen(
+                [actor, '--config', config, '--mock-master',
+                 '--shutdown-timeout', str(timeout)],
+                cwd=directory, stdout=output, stderr=subprocess.STDOUT)
+        errors = []
+        if not wait_for(output_path, 'has started', 2, 10):
+            errors.append('components did not start')
+        # let the components log, and the stuck one get stuck
+        time.sleep(0.3)
+        process.send_signal(sig)
+        try:
+            status = process.wait(timeout=10 + 2 * timeout)
+        except subprocess.TimeoutExpired:
+            process.kill()
+            process.wait()
+            return errors + ['did not exit']
+        with open(output_path) as output:
+            text = output.read()
+
+        expected = 1 if stuck else 0
+        if status != expected:
+            errors.append('exit status %d, expected %d' % (status, expected))
+        stages = STAGES.search(text)
+        if not stages:
+            errors.append('no shutdown timings')
+        else:
+            join, flush = [float(t) / 1000 for t in stages.groups()[2:]]
+            if stuck and not timeout <= join < timeout + 1:
+                errors.append('join took %.3f s, expected the %.3f s deadline'
+                              % (join, timeout))
+            if not stuck and join >= timeout:
+                errors.append('join took %.3f s' % join)
+            if flush >= timeout:
+                errors.append('flush took %.3f s' % flush)
+        if stuck and 'Component stuck did not stop in time' not in text:
+            errors.append('stuck component not reported')
+        for name in ('steady', 'stuck'):
+            check_log(os.path.join(directory, name + '.log'), errors)
+        if errors:
+            sys.stdout.write(text)
+        return errors
+    finally:
+        shutil.rmtree(directory)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('actor')
+    parser.add_argument('component')
+    parser.add_argument('--timeout', type=float, default=1.0)
+    args = parser.parse_args()
+    actor = os.path.abspath(args.actor)
+    library = os.path.abspath(args.component)
+
+    cases = [('SIGINT', signal.SIGINT, False),
+             ('SIGTERM', signal.SIGTERM, False),
+             ('SIGINT, stuck component', signal.SIGINT, True)]
+    failed = 0
+    for name, sig, stuck in cases:
+        errors = run_case(actor, library, sig, stuck, args.timeout)
+        print('%-26s %s' % (name, 'ok' if not errors else 'FAILED: ' + '; '.join(errors)))
+        failed += bool(errors)
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,351 @@
+/** @file    benchmarks.cpp
+ *  @date    October 2026
+ *  @brief   This file contains microbenchmarks for the actor's hot paths:
+ *           logging, component queue dispatch and JSON configuration
+ *           handling.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "rosmod_actor/binary_config.hpp"
+#include "rosmod_actor/json.hpp"
+#include "rosmod_actor/logger.hpp"
+#include "rosmod_actor/message_pool.hpp"
+#include "rosmod_actor/mock_master.hpp"
+#include "rosmod_actor/traced_callback_queue.hpp"
+
+#include "ros/ros.h"
+#include "ros/callback_queue.h"
+#include <std_msgs/Bool.h>
+
+/**
+ * @brief Builds a deployment configuration shaped like the ones ROSMOD
+ *        generates: per instance, logging settings, timers, ports and a
+ *        block of numeric parameters.
+ * @param[in] instances number of component instances.
+ */
+Json::Value makeDeploymentConfig(int instances) {
+  Json::Value root;
+  root["Name"] = "benchmark_node";
+  root["Priority"] = 50;
+  Json::Value& entries = root["Component Instances"] = Json::Value(Json::arrayValue);
+  for (int i = 0; i < instances; i++) {
+    std::ostringstream name;
+    name << "component_" << i;
+    Json::Value& comp = entries.append(Json::Value(Json::objectValue));
+    comp["Name"] = name.str();
+    comp["Definition"] = "/opt/rosmod/lib/lib" + name.str() + ".so";
+    comp["Logging"]["Component Logger"]["Enabled"] = true;
+    comp["Logging"]["Component Logger"]["Unit"] = 1024;
+    comp["Logging"]["Trace Logger"]["Enabled"] = false;
+    for (int t = 0; t < 4; t++) {
+      std::ostringstream timer;
+      timer << "timer_" << t;
+      comp["Timers"][timer.str()]["Period"] = 0.1 * (t + 1);
+      comp["Timers"][timer.str()]["Priority"] = 50 - t;
+      comp["Timers"][timer.str()]["Deadline"] = 0.1 * (t + 1);
+    }
+    for (int p = 0; p < 4; p++) {
+      std::ostringstream port;
+      port << "port_" << p;
+      comp["Publishers"][port.str()]["Topic"] = "/" + name.str() + "/" + port.str();
+      comp["Subscribers"][port.str()]["Topic"] = "/upstream/" + port.str();
+      comp["Subscribers"][port.str()]["Priority"] = 40;
+      comp["Subscribers"][port.str()]["Deadline"] = 0.05;
+    }
+    Json::Value& gains = comp["Parameters"]["Gains"] = Json::Value(Json::arrayValue);
+    for (int g = 0; g < 32; g++)
+      gains.append(1.0 / (g + 3));
+    comp["Parameters"]["Threshold"] = 0.75;
+    comp["Parameters"]["Label"] = "sensor fusion stage " + name.str();
+  }
+  return root;
+}
+
+std::string toDocument(const Json::Value& root) {
+  Json::StyledWriter writer;
+  return writer.write(root);
+}
+
+// ---------------------------------------------------------------------------
+// Logger
+
+static void BM_LoggerLog(benchmark::State& state) {
+  Logger logger;
+  logger.enable_logging();
+  logger.set_max_log_unit(64 * 1024);
+  logger.create_file("/dev/null");
+  int i = 0;
+  for (auto _ : state)
+    logger.log("INFO", "Timer %d expired, published %d samples", i++, 42);
+}
+BENCHMARK(BM_LoggerLog);
+
+static void BM_LoggerWrite(benchmark::State& state) {
+  Logger logger;
+  logger.enable_logging();
+  logger.set_is_periodic(false);
+  logger.create_file("/dev/null");
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (int i = 0; i < state.range(0); i++)
+      logger.raw_log("callback %d, %f", i, 0.5);
+    state.ResumeTiming();
+    logger.write();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoggerWrite)->Arg(100)->Arg(10000);
+
+// ---------------------------------------------------------------------------
+// Component queue dispatch
+
+/**
+ * @brief Callback doing no work, to measure the queue's own overhead.
+ */
+class NopCallback : public ros::CallbackInterface {
+public:
+  NopCallback() : calls(0) {}
+  virtual CallResult call() {
+    calls++;
+    return Success;
+  }
+  unsigned long calls;
+};
+
+static void BM_QueueDispatch(benchmark::State& state) {
+  // the component queue type, not a plain ros::CallbackQueue
+  TracedCallbackQueue queue;
+  queue.set_name("benchmark");
+  boost::shared_ptr<NopCallback> callback(new NopCallback());
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++)
+      queue.addCallback(callback);
+    queue.callAvailable(ros::WallDuration(0));
+  }
+  benchmark::DoNotOptimize(callback->calls);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_QueueDispatch)->Arg(1)->Arg(64);
+
+static void BM_IntraprocessPublish(benchmark::State& state) {
+  // roscpp can only be initialized once per process
+  static MockMaster master;
+  if (!ros::isInitialized()) {
+    if (!master.start()) {
+      state.SkipWithError("Couldn't start the mock master");
+      return;
+    }
+    ros::M_string remappings;
+    remappings["__master"] = master.uri();
+    ros::init(remappings, "rosmod_actor_benchmarks",
+	      ros::init_options::NoSigintHandler | ros::init_options::NoRosout);
+  }
+  ros::NodeHandle nh;
+  ros::CallbackQueue queue;
+  nh.setCallbackQueue(&queue);
+  int64_t received = 0;
+  boost::function<void(const std_msgs::Bool::ConstPtr&)> callback =
+    [&received](const std_msgs::Bool::ConstPtr&) { received++; };
+  // subscribing first connects the publisher on advertise, without waiting
+  // for the master's update
+  ros::Subscriber sub = nh.subscribe<std_msgs::Bool>("benchmark", 1000, callback);
+  ros::Publisher pub = nh.advertise<std_msgs::Bool>("benchmark", 1000);
+  std_msgs::Bool::Ptr msg(new std_msgs::Bool());
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++)
+      pub.publish(msg);
+    queue.callAvailable(ros::WallDuration(0));
+  }
+  if (received != state.iterations() * state.range(0))
+    state.SkipWithError("Messages were dropped");
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntraprocessPublish)->Arg(1)->Arg(64);
+
+/**
+ * @brief Message with a variable-length array, as deserialization fills it.
+ */
+struct SampleMessage {
+  std::vector<uint8_t> data;
+};
+
+static void BM_MessageAllocate(benchmark::State& state) {
+  for (auto _ : state) {
+    boost::shared_ptr<SampleMessage> message = boost::make_shared<SampleMessage>();
+    message->data.resize(state.range(0));
+    benchmark::DoNotOptimize(message->data.data());
+  }
+}
+BENCHMARK(BM_MessageAllocate)->Arg(64)->Arg(4096);
+
+static void BM_MessagePoolAcquire(benchmark::State& state) {
+  MessagePool<SampleMessage> pool("benchmark", 64);
+  for (auto _ : state) {
+    boost::shared_ptr<SampleMessage> message = pool.acquire();
+    message->data.resize(state.range(0));
+    benchmark::DoNotOptimize(message->data.data());
+  }
+  state.counters["hit_rate"] = static_cast<double>(pool.hits()) /
+    (pool.hits() + pool.misses());
+}
+BENCHMARK(BM_MessagePoolAcquire)->Arg(64)->Arg(4096);
+
+// ---------------------------------------------------------------------------
+// JSON configuration
+
+static void BM_ReaderParse(benchmark::State& state) {
+  std::string document = toDocument(makeDeploymentConfig(state.range(0)));
+  for (auto _ : state) {
+    Json::Reader reader;
+    Json::Value root;
+    benchmark::DoNotOptimize(reader.parse(document, root, false));
+  }
+  state.SetBytesProcessed(state.iterations() * document.size());
+}
+BENCHMARK(BM_ReaderParse)->Arg(10)->Arg(100);
+
+static void BM_CharReaderParse(benchmark::State& state) {
+  std::string document = toDocument(makeDeploymentConfig(state.range(0)));
+  Json::CharReaderBuilder builder;
+  builder["collectComments"] = false;
+  std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  for (auto _ : state) {
+    Json::Value root;
+    benchmark::DoNotOptimize(reader->parse(document.data(),
+                                           document.data() + document.size(),
+                                           &root, NULL));
+  }
+  state.SetBytesProcessed(state.iterations() * document.size());
+}
+BENCHMARK(BM_CharReaderParse)->Arg(10)->Arg(100);
+
+static void BM_BinaryConfigLoad(benchmark::State& state) {
+  char path[] = "/tmp/rosmod_actor_benchmark_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    state.SkipWithError("Couldn't create temporary file");
+    return;
+  }
+  close(fd);
+  {
+    std::ofstream out(path, std::ofstream::binary);
+    BinaryConfig::write(makeDeploymentConfig(state.range(0)), out);
+  }
+  for (auto _ : state) {
+    BinaryConfig config;
+    Json::Value root;
+    benchmark::DoNotOptimize(config.load(path, root));
+  }
+  unlink(path);
+}
+BENCHMARK(BM_BinaryConfigLoad)->Arg(10)->Arg(100);
+
+static void BM_ValueLookup(benchmark::State& state) {
+  const Json::Value root = makeDeploymentConfig(10);
+  const Json::Value& config = root["Component Instances"][5];
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(&config["Name"]);
+    benchmark::DoNotOptimize(&config["Timers"]["timer_2"]["Period"]);
+    benchmark::DoNotOptimize(&config["Parameters"]["Threshold"]);
+  }
+}
+BENCHMARK(BM_ValueLookup);
+
+static void BM_ValueLookupKey(benchmark::State& state) {
+  const Json::Value root = makeDeploymentConfig(10);
+  const Json::Value& config = root["Component Instances"][5];
+  Json::Key name("Name"), timers("Timers"), timer("timer_2"), period("Period");
+  Json::Key parameters("Parameters"), threshold("Threshold");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(&config[name]);
+    benchmark::DoNotOptimize(&config[timers][timer][period]);
+    benchmark::DoNotOptimize(&config[parameters][threshold]);
+  }
+}
+BENCHMARK(BM_ValueLookupKey);
+
+static void BM_FastWriter(benchmark::State& state) {
+  const Json::Value root = makeDeploymentConfig(state.range(0));
+  Json::FastWriter writer;
+  std::string document;
+  for (auto _ : state) {
+    document.clear();
+    writer.write(root, &document);
+  }
+  state.SetBytesProcessed(state.iterations() * document.size());
+}
+BENCHMARK(BM_FastWriter)->Arg(10)->Arg(100);
+
+static void BM_StyledWriter(benchmark::State& state) {
+  const Json::Value root = makeDeploymentConfig(state.range(0));
+  Json::StyledWriter writer;
+  std::string document;
+  for (auto _ : state) {
+    document.clear();
+    writer.write(root, &document);
+  }
+  state.SetBytesProcessed(state.iterations() * document.size());
+}
+BENCHMARK(BM_StyledWriter)->Arg(10)->Arg(100);
+
+static void BM_StreamWriter(benchmark::State& state) {
+  const Json::Value root = makeDeploymentConfig(state.range(0));
+  Json::StreamWriterBuilder builder;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::string document = Json::writeString(builder, root);
+    bytes = document.size();
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_StreamWriter)->Arg(10)->Arg(100);
+
+static void BM_WriteDoubles(benchmark::State& state) {
+  Json::Value samples(Json::arrayValue);
+  for (int i = 0; i < 10000; i++)
+    samples.append(i * 0.001 + 1.0 / (i + 7));
+  Json::FastWriter writer;
+  std::string document;
+  for (auto _ : state) {
+    document.clear();
+    writer.write(samples, &document);
+  }
+  state.SetItemsProcessed(state.iterations() * samples.size());
+  state.SetBytesProcessed(state.iterations() * document.size());
+}
+BENCHMARK(BM_WriteDoubles);
+
+/**
+ * @brief Runs the benchmarks, writing results to JSON by default.
+ *
+ * Unless --benchmark_out is given, results also go to
+ * rosmod_actor_benchmarks.json in the working directory.
+ */
+int main(int argc, char** argv) {
+  std::vector<char*> args(argv, argv + argc);
+  bool hasOut = false;
+  for (int i = 1; i < argc; i++)
+    hasOut = hasOut || strncmp(argv[i], "--benchmark_out=", 16) == 0;
+  char out[] = "--benchmark_out=rosmod_actor_benchmarks.json";
+  char format[] = "--benchmark_out_format=json";
+  if (!hasOut) {
+    args.push_back(out);
+    args.push_back(format);
+  }
+  int count = static_cast<int>(args.size());
+  benchmark::Initialize(&count, &args[0]);
+  if (benchmark::ReportUnrecognizedArguments(count, &args[0]))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  if (ros::isInitialized())
+    ros::shutdown();
+  return 0;
+}
@@ -0,0 +1,297 @@
+/** @file    binary_config.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the BinaryConfig class
+ */
+
+#include "rosmod_actor/binary_config.hpp"
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char   kMagic[8] = {'R', 'M', 'O', 'D', 'C', 'F', 'G', '1'};
+const int    kMaxDepth = 1000;  // same as the JSON reader's stackLimit
+const size_t kMinElement = 1;   // a tag
+const size_t kMinMember = 6;    // an empty key (length and '\0') and a tag
+
+enum Tag {
+  tagNull = 0,
+  tagFalse,
+  tagTrue,
+  tagInt,
+  tagUInt,
+  tagReal,
+  tagString,
+  tagArray,
+  tagObject
+};
+
+void put_u8(std::ostream& out, uint8_t value) {
+  out.put(static_cast<char>(value));
+}
+
+void put_u32(std::ostream& out, uint32_t value) {
+  char bytes[4];
+  for (int i = 0; i < 4; i++)
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  out.write(bytes, sizeof(bytes));
+}
+
+void put_u64(std::ostream& out, uint64_t value) {
+  char bytes[8];
+  for (int i = 0; i < 8; i++)
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  out.write(bytes, sizeof(bytes));
+}
+
+void put_string(std::ostream& out, const char* begin, const char* end) {
+  put_u32(out, static_cast<uint32_t>(end - begin));
+  out.write(begin, end - begin);
+  out.put('\0');
+}
+
+void put_value(std::ostream& out, const Json::Value& value) {
+  switch (value.type()) {
+  case Json::nullValue:
+    put_u8(out, tagNull);
+    break;
+  case Json::booleanValue:
+    put_u8(out, value.asBool() ? tagTrue : tagFalse);
+    break;
+  case Json::intValue:
+    put_u8(out, tagInt);
+    put_u64(out, static_cast<uint64_t>(value.asLargestInt()));
+    break;
+  case Json::uintValue:
+    put_u8(out, tagUInt);
+    put_u64(out, value.asLargestUInt());
+    break;
+  case Json::realValue: {
+    double real = value.asDouble();
+    uint64_t bits;
+    memcpy(&bits, &real, sizeof(bits));
+    put_u8(out, tagReal);
+    put_u64(out, bits);
+  } break;
+  case Json::stringValue: {
+    const char* begin;
+    const char* end;
+    value.getString(&begin, &end);
+    put_u8(out, tagString);
+    put_string(out, begin, end);
+  } break;
+  case Json::arrayValue:
+    put_u8(out, tagArray);
+    put_u32(out, value.size());
+    for (Json::ArrayIndex i = 0; i < value.size(); i++)
+      put_value(out, value[i]);
+    break;
+  case Json::objectValue:
+    put_u8(out, tagObject);
+    put_u32(out, value.size());
+    for (Json::Value::const_iterator it = value.begin(); it != value.end(); ++it) {
+      const char* end;
+      const char* begin = it.memberName(&end);
+      put_string(out, begin, end);
+      put_value(out, *it);
+    }
+    break;
+  }
+}
+
+/**
+ * @brief Bounds-checked cursor over the mapped file.
+ */
+class Loader {
+public:
+  Loader(const char* begin, const char* end) : current_(begin), end_(end) {}
+
+  bool load_value(Json::Value& value, int depth) {
+    uint8_t tag;
+    if (depth > kMaxDepth || !get_u8(tag))
+      return false;
+    switch (tag) {
+    case tagNull:
+      value = Json::Value();
+      return true;
+    case tagFalse:
+    case tagTrue:
+      value = Json::Value(tag == tagTrue);
+      return true;
+    case tagInt: {
+      uint64_t bits;
+      if (!get_u64(bits))
+        return false;
+      value = Json::Value(static_cast<Json::LargestInt>(bits));
+      return true;
+    }
+    case tagUInt: {
+      uint64_t bits;
+      if (!get_u64(bits))
+        return false;
+      value = Json::Value(static_cast<Json::LargestUInt>(bits));
+      return true;
+    }
+    case tagReal: {
+      uint64_t bits;
+      double real;
+      if (!get_u64(bits))
+        return false;
+      memcpy(&real, &bits, sizeof(real));
+      value = Json::Value(real);
+      return true;
+    }
+    case tagString: {
+      const char* str;
+      uint32_t length;
+      if (!get_string(str, length))
+        return false;
+      if (memchr(str, '\0', length) == NULL)
+        value = Json::Value(Json::StaticString(str));
+      else
+        value = Json::Value(str, str + length);
+      return true;
+    }
+    case tagArray: {
+      uint32_t count;
+      if (!get_count(count, kMinElement))
+        return false;
+      value = Json::Value(Json::arrayValue);
+      if (count > 0)
+        value.resize(count);
+      for (uint32_t i = 0; i < count; i++) {
+        if (!load_value(value[i], depth + 1))
+          return false;
+      }
+      return true;
+    }
+    case tagObject: {
+      uint32_t count;
+      if (!get_count(count, kMinMember))
+        return false;
+      value = Json::Value(Json::objectValue);
+      for (uint32_t i = 0; i < count; i++) {
+        const char* key;
+        uint32_t length;
+        if (!get_string(key, length))
+          return false;
+        // Member names without embedded '\0' are referenced, not copied
+        Json::Value& member = memchr(key, '\0', length) == NULL ?
+          value[Json::StaticString(key)] :
+          value[std::string(key, length)];
+        if (!load_value(member, depth + 1))
+          return false;
+      }
+      return true;
+    }
+    default:
+      return false;
+    }
+  }
+
+  bool at_end() const { return current_ == end_; }
+
+private:
+  bool get_u8(uint8_t& value) {
+    if (end_ - current_ < 1)
+      return false;
+    value = static_cast<uint8_t>(*current_++);
+    return true;
+  }
+
+  bool get_u32(uint32_t& value) {
+    if (end_ - current_ < 4)
+      return false;
+    value = 0;
+    for (int i = 0; i < 4; i++)
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(current_[i])) << (8 * i);
+    current_ += 4;
+    return true;
+  }
+
+  bool get_u64(uint64_t& value) {
+    if (end_ - current_ < 8)
+      return false;
+    value = 0;
+    for (int i = 0; i < 8; i++)
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(current_[i])) << (8 * i);
+    current_ += 8;
+    return true;
+  }
+
+  // An element count, rejected if the rest of the file can't hold that many
+  // elements of at least min_size bytes, before anything is allocated for them
+  bool get_count(uint32_t& count, size_t min_size) {
+    return get_u32(count) && count <= static_cast<size_t>(end_ - current_) / min_size;
+  }
+
+  bool get_string(const char*& str, uint32_t& length) {
+    if (!get_u32(length) || static_cast<uint64_t>(end_ - current_) < length + 1ull)
+      return false;
+    str = current_;
+    current_ += length;
+    return *current_++ == '\0';
+  }
+
+  const char* current_;
+  const char* end_;
+};
+
+}  // namespace
+
+BinaryConfig::BinaryConfig() : mapping_(NULL), size_(0) {}
+
+BinaryConfig::~BinaryConfig() {
+  unmap();
+}
+
+bool BinaryConfig::is_binary(const std::string& path) {
+  std::ifstream file(path.c_str(), std::ifstream::binary);
+  char magic[sizeof(kMagic)];
+  if (!file.read(magic, sizeof(magic)))
+    return false;
+  return memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool BinaryConfig::write(const Json::Value& root, std::ostream& out) {
+  out.write(kMagic, sizeof(kMagic));
+  put_value(out, root);
+  return static_cast<bool>(out);
+}
+
+bool BinaryConfig::load(const std::string& path, Json::Value& root) {
+  unmap();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(kMagic))) {
+    close(fd);
+    return false;
+  }
+  void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+    return false;
+  mapping_ = mapping;
+  size_ = st.st_size;
+
+  const char* begin = static_cast<const char*>(mapping_);
+  if (memcmp(begin, kMagic, sizeof(kMagic)) != 0)
+    return false;
+  Loader loader(begin + sizeof(kMagic), begin + size_);
+  return loader.load_value(root, 0) && loader.at_end();
+}
+
+void BinaryConfig::unmap() {
+  if (mapping_ != NULL) {
+    munmap(mapping_, size_);
+    mapping_ = NULL;
+    size_ = 0;
+  }
+}
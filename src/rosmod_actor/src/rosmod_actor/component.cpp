@@ -6,13 +6,79 @@
  */
 
 #include "rosmod_actor/component.hpp"
+#include <time.h>
 #include <unistd.h>
+#include <sys/resource.h>
+
+/**
+ * @brief Queue entry running one replayed event on the component thread.
+ */
+class ReplayCallback : public ros::CallbackInterface {
+public:
+  ReplayCallback(Component* component, const ReplayEvent& event,
+		 std::chrono::steady_clock::time_point scheduled)
+    : component_(component), event_(event), scheduled_(scheduled) {}
+
+  virtual CallResult call() {
+    component_->run_replay_event(event_, scheduled_);
+    return Success;
+  }
+
+private:
+  Component* component_;
+  ReplayEvent event_;
+  std::chrono::steady_clock::time_point scheduled_;
+};
 
 // Constructor
-Component::Component(Json::Value& _config) {
+Component::Component(const Json::Value& _config) : config(_config) {
+  init();
+}
+
+// Constructor taking ownership of the configuration
+Component::Component(Json::Value&& _config)
+  : owned_config_(new Json::Value(std::move(_config))), config(*owned_config_) {
+  init();
+}
+
+// Shared constructor body
+void Component::init() {
   logger.reset(new Logger());
   trace.reset(new Logger());
-  config = _config;
+  replay_pending_ = 0;
+  comp_queue.set_name(config["Name"].asString());
+
+  // Format, compress and rotate the log files as configured under "Logging"
+  const char* loggers[] = {"Component Logger", "Trace Logger"};
+  Logger* targets[] = {logger.get(), trace.get()};
+  for (int i = 0; i < 2; i++) {
+    const Json::Value& settings = config["Logging"][loggers[i]];
+    std::string format_name = settings.get("Format", "Text").asString();
+    StructuredLog::Format format;
+    if (StructuredLog::parse(format_name, format))
+      targets[i]->set_format(format);
+    else
+      ROS_ERROR_STREAM("Unknown " << loggers[i] << " format " << format_name);
+    std::string name = settings.get("Compression", "None").asString();
+    LogCompressor::Method compression;
+    if (LogCompressor::parse(name, compression))
+      targets[i]->set_compression(compression);
+    else
+      ROS_ERROR_STREAM("Unknown " << loggers[i] << " compression " << name);
+    if (settings.isMember("Segment Size") || settings.isMember("Segment Interval"))
+      targets[i]->set_rotation(settings.get("Segment Size", 0).asUInt64(),
+			       settings.get("Segment Interval", 0.0).asDouble(),
+			       settings.get("Keep Segments", 10).asInt());
+  }
+
+  // Sample the CPU usage of the component thread, if configured
+  cpu_usage_ = CpuUsage();
+  cpu_usage_.start = cpu_usage_.last = std::chrono::steady_clock::now();
+  double interval = config.get("CPU Accounting Interval", 0.0).asDouble();
+  if (interval > 0)
+    cpu_usage_.timer = add_periodic_timer("CPU accounting", interval, [this](const ros::TimerEvent&) {
+      sample_cpu_usage();
+    });
 
   // Identify the pwd of Node Executable
   char cwd[1024];
@@ -30,10 +96,39 @@ Component::~Component() {
     config["Name"].asString() <<
     " - writing out logs!" << "\n";
   comp_queue.disable();
-  // make sure all user logs are written
-  logger->write();
-  // make sure all trace logs are written
-  trace->write();
+  cancel_periodic_timers();
+  // summarize timer lateness
+  Json::FastWriter writer;
+  writer.omitEndingLineFeed();
+  for (size_t i = 0; i < periodic_timers_.size(); i++) {
+    Json::Value summary = periodic_timers_[i]->stats.summary();
+    summary["timer"] = periodic_timers_[i]->name;
+    logger->log("TIMER", "%s", writer.write(summary).c_str());
+  }
+  // report message pool hit rates
+  for (std::map<std::string, std::shared_ptr<MessagePoolBase> >::const_iterator it =
+	 message_pools_.begin(); it != message_pools_.end(); ++it) {
+    uint64_t hits = it->second->hits();
+    uint64_t total = hits + it->second->misses();
+    trace->log("POOL", "Message pool %s: %llu hits, %llu misses, hit rate %.4f",
+	       it->first.c_str(),
+	       static_cast<unsigned long long>(hits),
+	       static_cast<unsigned long long>(total - hits),
+	       total ? static_cast<double>(hits) / total : 0.0);
+  }
+  // summarize CPU usage
+  if (cpu_usage_.samples > 0) {
+    double wall_us = std::chrono::duration<double, std::micro>
+      (cpu_usage_.last - cpu_usage_.start).count();
+    trace->log("CPU", "CPU usage over %llu samples: %.0f us CPU (%.2f%%), "
+	       "%ld voluntary and %ld involuntary context switches, "
+	       "scheduling latency mean %.1f us, max %.1f us",
+	       static_cast<unsigned long long>(cpu_usage_.samples), cpu_usage_.cpu_us,
+	       wall_us > 0 ? 100 * cpu_usage_.cpu_us / wall_us : 0.0,
+	       cpu_usage_.voluntary, cpu_usage_.involuntary,
+	       cpu_usage_.latency_sum_us / cpu_usage_.samples, cpu_usage_.latency_max_us);
+  }
+  flush_logs();
 }
 
 // Component Operation Queue Handler
@@ -41,3 +136,130 @@ void Component::process_queue() {
   while (nh_.ok())
     this->comp_queue.callAvailable(ros::WallDuration(0.01));
 }
+
+// Stop the Component and its Operation Queue
+void Component::stop() {
+  cancel_periodic_timers();
+  nh_.shutdown();
+  comp_queue.disable();
+  comp_queue.clear();
+}
+
+// Start a timer on the actor's timer engine
+PeriodicTimerPtr Component::add_periodic_timer(const std::string& name, double period,
+					       const PeriodicTimer::Callback& callback) {
+  PeriodicTimerPtr timer = TimerEngine::instance().add(
+    name,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(period)),
+    callback, &comp_queue, reinterpret_cast<uint64_t>(this));
+  std::lock_guard<std::mutex> lock(periodic_timers_mutex_);
+  periodic_timers_.push_back(timer);
+  return timer;
+}
+
+PeriodicTimerPtr Component::add_once_timer(const std::string& name,
+					   const PeriodicTimer::Callback& callback) {
+  PeriodicTimerPtr timer = TimerEngine::instance().add_once(name, callback, &comp_queue,
+							     reinterpret_cast<uint64_t>(this));
+  std::lock_guard<std::mutex> lock(periodic_timers_mutex_);
+  periodic_timers_.push_back(timer);
+  return timer;
+}
+
+void Component::cancel_periodic_timers() {
+  std::lock_guard<std::mutex> lock(periodic_timers_mutex_);
+  for (size_t i = 0; i < periodic_timers_.size(); i++)
+    TimerEngine::instance().cancel(periodic_timers_[i]);
+}
+
+void Component::sample_cpu_usage() {
+  struct timespec cpu;
+  struct rusage usage;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu) != 0 ||
+      getrusage(RUSAGE_THREAD, &usage) != 0)
+    return;
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  double cpu_us = cpu.tv_sec * 1e6 + cpu.tv_nsec / 1e3;
+  // ROS time would be wrong under sim time, and stopped while replaying
+  double latency_us = cpu_usage_.timer->stats.last_us;
+  double wall_us = std::chrono::duration<double, std::micro>(now - cpu_usage_.last).count();
+
+  // the first sample covers the thread's startup
+  trace->log("CPU", "%.0f us CPU (%.2f%%), %ld voluntary and %ld involuntary "
+	     "context switches, scheduling latency %.1f us",
+	     cpu_us - cpu_usage_.cpu_us,
+	     wall_us > 0 ? 100 * (cpu_us - cpu_usage_.cpu_us) / wall_us : 0.0,
+	     usage.ru_nvcsw - cpu_usage_.voluntary, usage.ru_nivcsw - cpu_usage_.involuntary,
+	     latency_us);
+  cpu_usage_.samples++;
+  cpu_usage_.cpu_us = cpu_us;
+  cpu_usage_.voluntary = usage.ru_nvcsw;
+  cpu_usage_.involuntary = usage.ru_nivcsw;
+  cpu_usage_.latency_sum_us += latency_us;
+  cpu_usage_.latency_max_us = std::max(cpu_usage_.latency_max_us, latency_us);
+  cpu_usage_.last = now;
+}
+
+void Component::batch_limits(const std::string& topic, size_t& max_messages,
+			     double& max_delay) const {
+  const Json::Value& batching = config["Batching"][topic];
+  max_messages = batching.get("Max Messages", 64).asUInt();
+  max_delay = batching.get("Max Delay", 0.001).asDouble();
+  if (max_messages == 0 || max_delay <= 0) {
+    ROS_ERROR_STREAM("Invalid batching for " << topic << ", using the defaults");
+    max_messages = 64;
+    max_delay = 0.001;
+  }
+}
+
+// Write out buffered logs
+void Component::flush_logs() {
+  // make sure all user logs are written
+  logger->write();
+  // make sure all trace logs are written
+  trace->write();
+}
+
+// Queue a recorded event
+void Component::replay(const ReplayEvent& event,
+		       std::chrono::steady_clock::time_point scheduled) {
+  replay_pending_++;
+  comp_queue.addCallback(ros::CallbackInterfacePtr(new ReplayCallback(this, event, scheduled)));
+}
+
+bool Component::replay_idle() const {
+  return replay_pending_ == 0;
+}
+
+const std::map<std::string, ReplayStats>& Component::replay_stats() const {
+  return replay_stats_;
+}
+
+void Component::register_replay_handler(const std::string& channel,
+					const ReplayHandler& handler) {
+  replay_handlers_[channel] = handler;
+}
+
+// Replay a recorded event on the component thread
+void Component::run_replay_event(const ReplayEvent& event,
+				 std::chrono::steady_clock::time_point scheduled) {
+  std::map<std::string, ReplayHandler>::iterator handler =
+    replay_handlers_.find(event.channel);
+  if (handler == replay_handlers_.end()) {
+    // events for all components only count where they are handled
+    if (!event.component.empty())
+      replay_stats_[event.channel].unhandled++;
+  } else {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    try {
+      handler->second(event);
+    } catch (std::exception& e) {
+      ROS_ERROR_STREAM("Replaying " << event.channel << " failed: " << e.what());
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    ReplayStats& stats = replay_stats_[event.channel];
+    stats.execution_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    stats.delay_us.push_back(std::chrono::duration<double, std::micro>(start - scheduled).count());
+  }
+  replay_pending_--;
+}
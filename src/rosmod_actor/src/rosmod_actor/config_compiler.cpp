@@ -0,0 +1,65 @@
+/** @file    config_compiler.cpp
+ *  @date    October 2026
+ *  @brief   This file contains the main function for the tool converting
+ *           deployment JSON into the binary configuration format.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "rosmod_actor/binary_config.hpp"
+#include "rosmod_actor/json.hpp"
+
+void printHelp() {
+  std::cerr << "\nUsage:  rosmod_config_compiler <json config file> <binary config file>\n";
+}
+
+/**
+ * @brief Parses a deployment JSON and writes it out as a binary config.
+ *
+ */
+int main(int argc, char **argv)
+{
+  if (argc != 3) {
+    printHelp();
+    return 1;
+  }
+
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  builder["collectComments"] = false;
+  std::string errs;
+  std::ifstream input(argv[1], std::ifstream::binary);
+  if (!input || !Json::parseFromStream(builder, input, &root, &errs)) {
+    std::cerr << "Couldn't parse " << argv[1] << ": " << errs << std::endl;
+    return 1;
+  }
+
+  // A running actor keeps the old file mapped, so it is replaced rather
+  // than rewritten: write a temporary file next to it, then rename it over
+  std::string temporary = std::string(argv[2]) + ".XXXXXX";
+  int fd = mkstemp(&temporary[0]);
+  if (fd < 0) {
+    std::cerr << "Couldn't create " << temporary << ": " << strerror(errno) << std::endl;
+    return 1;
+  }
+  bool written;
+  {
+    std::ofstream output(temporary.c_str(), std::ofstream::binary | std::ofstream::trunc);
+    written = output && BinaryConfig::write(root, output) && output.flush();
+  }
+  if (!written || fchmod(fd, 0644) != 0 || fsync(fd) != 0 ||
+      rename(temporary.c_str(), argv[2]) != 0) {
+    std::cerr << "Couldn't write " << argv[2] << std::endl;
+    close(fd);
+    unlink(temporary.c_str());
+    return 1;
+  }
+  close(fd);
+  return 0;
+}
@@ -0,0 +1,182 @@
+/** @file    log_compression.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the compression of written logs
+ */
+
+#include "rosmod_actor/log_compression.hpp"
+#include <algorithm>
+#include <string.h>
+#include <stdint.h>
+#ifdef ROSMOD_ACTOR_ZSTD
+#include <zstd.h>
+#endif
+
+#include "ros/ros.h"
+
+namespace {
+
+const size_t kBlockSize = 64 * 1024;  // LZ4 frame block maximum, BD = 4
+const size_t kMinMatch = 4;
+const size_t kMatchLimit = 12;        // no match starts in the last 12 bytes
+const size_t kLastLiterals = 5;       // and the last 5 are literals
+const int kHashBits = 12;
+
+uint32_t read32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void write32(uint8_t* p, uint32_t value) {
+  p[0] = value;
+  p[1] = value >> 8;
+  p[2] = value >> 16;
+  p[3] = value >> 24;
+}
+
+uint32_t rotl32(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+/**
+ * @brief xxHash32 of fewer than 16 bytes, for the frame header checksum.
+ */
+uint32_t xxh32Small(const uint8_t* p, size_t size) {
+  const uint32_t prime1 = 2654435761U, prime2 = 2246822519U, prime3 = 3266489917U,
+    prime4 = 668265263U, prime5 = 374761393U;
+  uint32_t h = prime5 + size;
+  const uint8_t* end = p + size;
+  for (; p + 4 <= end; p += 4)
+    h = rotl32(h + read32(p) * prime3, 17) * prime4;
+  for (; p < end; p++)
+    h = rotl32(h + *p * prime5, 11) * prime1;
+  h ^= h >> 15;
+  h *= prime2;
+  h ^= h >> 13;
+  h *= prime3;
+  h ^= h >> 16;
+  return h;
+}
+
+uint8_t* writeLength(uint8_t* op, size_t length) {
+  for (; length >= 255; length -= 255)
+    *op++ = 255;
+  *op++ = length;
+  return op;
+}
+
+// One LZ4 sequence: literals, then a match unless offset is 0
+uint8_t* writeSequence(uint8_t* op, const uint8_t* literals, size_t literal_length,
+		       size_t offset, size_t match_length) {
+  uint8_t* token = op++;
+  *token = (literal_length >= 15 ? 15 : literal_length) << 4;
+  if (literal_length >= 15)
+    op = writeLength(op, literal_length - 15);
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (offset == 0)
+    return op;
+  *op++ = offset;
+  *op++ = offset >> 8;
+  match_length -= kMinMatch;
+  *token |= match_length >= 15 ? 15 : match_length;
+  if (match_length >= 15)
+    op = writeLength(op, match_length - 15);
+  return op;
+}
+
+/**
+ * @brief Greedy LZ4 block compression.
+ * @param[out] dst room for size + size / 255 + 16 bytes.
+ * @return the compressed size.
+ */
+size_t lz4CompressBlock(const uint8_t* src, size_t size, uint8_t* dst) {
+  uint32_t table[1 << kHashBits];
+  memset(table, 0xff, sizeof(table));
+  uint8_t* op = dst;
+  size_t anchor = 0;
+  for (size_t i = 0; i + kMatchLimit <= size; ) {
+    uint32_t sequence = read32(src + i);
+    uint32_t hash = (sequence * 2654435761U) >> (32 - kHashBits);
+    uint32_t candidate = table[hash];
+    table[hash] = i;
+    if (candidate == 0xffffffff || i - candidate > 65535 || read32(src + candidate) != sequence) {
+      i++;
+      continue;
+    }
+    size_t length = kMinMatch;
+    size_t limit = size - kLastLiterals - i;
+    while (length < limit && src[candidate + length] == src[i + length])
+      length++;
+    op = writeSequence(op, src + anchor, i - anchor, i - candidate, length);
+    i += length;
+    anchor = i;
+  }
+  return writeSequence(op, src + anchor, size - anchor, 0, 0) - dst;
+}
+
+void lz4Frame(const char* data, size_t size, std::string& frame) {
+  // header, blocks at worst case with their sizes, end mark
+  frame.resize(7 + size + size / 255 + 20 * (size / kBlockSize + 1) + 4);
+  uint8_t* out = reinterpret_cast<uint8_t*>(&frame[0]);
+  uint8_t* op = out;
+  // magic, FLG: version 1, independent blocks; BD: 64 KB blocks
+  write32(op, 0x184D2204);
+  op[4] = 0x60;
+  op[5] = 0x40;
+  op[6] = (xxh32Small(op + 4, 2) >> 8) & 0xff;
+  op += 7;
+  const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+  for (size_t offset = 0; offset < size; offset += kBlockSize) {
+    size_t length = std::min(kBlockSize, size - offset);
+    size_t compressed = lz4CompressBlock(src + offset, length, op + 4);
+    if (compressed >= length) {
+      // incompressible: store it, flagged by the high bit
+      memcpy(op + 4, src + offset, length);
+      write32(op, length | 0x80000000U);
+      op += 4 + length;
+    } else {
+      write32(op, compressed);
+      op += 4 + compressed;
+    }
+  }
+  write32(op, 0);  // end mark
+  frame.resize(op + 4 - out);
+}
+
+}  // namespace
+
+bool LogCompressor::parse(const std::string& name, Method& method) {
+  if (name == "None") {
+    method = none;
+  } else if (name == "LZ4") {
+    method = lz4;
+  } else if (name == "Zstd") {
+#ifdef ROSMOD_ACTOR_ZSTD
+    method = zstd;
+#else
+    ROS_WARN_STREAM("Built without zstd, compressing logs with LZ4");
+    method = lz4;
+#endif
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void LogCompressor::compress(Method method, const char* data, size_t size, std::string& frame) {
+#ifdef ROSMOD_ACTOR_ZSTD
+  if (method == zstd) {
+    frame.resize(ZSTD_compressBound(size));
+    size_t compressed = ZSTD_compress(&frame[0], frame.size(), data, size, 3);
+    if (!ZSTD_isError(compressed)) {
+      frame.resize(compressed);
+      return;
+    }
+    ROS_ERROR_STREAM("Couldn't compress log: " << ZSTD_getErrorName(compressed));
+  }
+#else
+  (void)method;  // only lz4 without zstd
+#endif
+  lz4Frame(data, size, frame);
+}
@@ -0,0 +1,135 @@
+/** @file    log_rotation.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the background work of log file rotation
+ */
+
+#include "rosmod_actor/log_rotation.hpp"
+#include "rosmod_actor/timeline.hpp"
+#include <algorithm>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <vector>
+
+#include "ros/ros.h"
+
+namespace {
+
+// Directory and file name of a path
+void splitPath(const std::string& path, std::string& directory, std::string& name) {
+  size_t slash = path.rfind('/');
+  directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+  name = slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Numbers of the segments of the log at path
+std::vector<int> listSegments(const std::string& path) {
+  std::vector<int> segments;
+  std::string directory, name;
+  splitPath(path, directory, name);
+  DIR* dir = opendir(directory.c_str());
+  if (dir == NULL)
+    return segments;
+  std::string prefix = name + ".";
+  while (struct dirent* entry = readdir(dir)) {
+    const char* suffix = entry->d_name + prefix.size();
+    if (strncmp(entry->d_name, prefix.c_str(), prefix.size()) != 0 || *suffix == '\0' ||
+	strspn(suffix, "0123456789") != strlen(suffix))
+      continue;
+    segments.push_back(atoi(suffix));
+  }
+  closedir(dir);
+  return segments;
+}
+
+}  // namespace
+
+LogRotator& LogRotator::instance() {
+  static LogRotator rotator;
+  return rotator;
+}
+
+LogRotator::LogRotator() : stopping_(false), thread_(&LogRotator::run, this) {}
+
+LogRotator::~LogRotator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_one();
+  thread_.join();
+}
+
+int LogRotator::last_segment(const std::string& path) {
+  int last = 0;
+  std::vector<int> segments = listSegments(path);
+  for (size_t i = 0; i < segments.size(); i++)
+    last = std::max(last, segments[i]);
+  return last;
+}
+
+void LogRotator::preallocate(const std::string& path, size_t size) {
+  submit([path, size]() {
+      int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+      if (fd < 0) {
+	ROS_WARN_STREAM("Couldn't preallocate log " << path << ": " << strerror(errno));
+	return;
+      }
+      // reserve the blocks, but keep the size so appends and readers see no padding
+      if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size) != 0 && errno != EOPNOTSUPP)
+	ROS_WARN_STREAM("Couldn't preallocate log " << path << ": " << strerror(errno));
+      close(fd);
+    });
+}
+
+void LogRotator::retire(const std::string& segment, const std::string& path, int oldest_kept) {
+  submit([segment, path, oldest_kept]() {
+      // release the preallocated blocks past the end of the segment;
+      // truncating to its own size frees them, where ext4 ignores a hole
+      // punched past the end
+      int fd = open(segment.c_str(), O_WRONLY | O_CLOEXEC);
+      struct stat status;
+      if (fd >= 0 && fstat(fd, &status) == 0 &&
+	  static_cast<off_t>(status.st_blocks) * 512 > status.st_size &&
+	  ftruncate(fd, status.st_size) != 0)
+	ROS_WARN_STREAM("Couldn't release the space of log " << segment << ": " <<
+			strerror(errno));
+      if (fd >= 0)
+	close(fd);
+      std::vector<int> segments = listSegments(path);
+      for (size_t i = 0; i < segments.size(); i++) {
+	if (segments[i] >= oldest_kept)
+	  continue;
+	std::string expired = path + "." + std::to_string(segments[i]);
+	if (unlink(expired.c_str()) != 0 && errno != ENOENT)
+	  ROS_WARN_STREAM("Couldn't delete log " << expired << ": " << strerror(errno));
+      }
+    });
+}
+
+void LogRotator::submit(const std::function<void()>& job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+  }
+  ready_.notify_one();
+}
+
+void LogRotator::run() {
+  Timeline::instance().name_thread("log rotator");
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    ready_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+    if (jobs_.empty())
+      return;
+    std::function<void()> job = jobs_.front();
+    jobs_.pop_front();
+    lock.unlock();
+    job();
+    lock.lock();
+  }
+}
@@ -0,0 +1,322 @@
+/** @file    log_sink.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the raw file descriptor sink of the loggers
+ */
+
+#include "rosmod_actor/log_sink.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef ROSMOD_ACTOR_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#include "ros/ros.h"
+#include "rosmod_actor/timeline.hpp"
+
+namespace {
+
+const unsigned kBatch = 16;  // deferred writes submitted together
+const std::chrono::milliseconds kMaxDeferral(2);  // longest a write stays unsubmitted
+
+}  // namespace
+
+LogSink& LogSink::instance() {
+  static LogSink sink;
+  return sink;
+}
+
+LogSink::LogSink()
+  : stopping_(false), ring_fd_(-1), entries_(0), completions_(0), inflight_(0), sq_ring_(NULL), sq_ring_size_(0),
+    cq_ring_(NULL), cq_ring_size_(0), sqes_(NULL), sqes_size_(0), sq_head_(NULL), sq_tail_(NULL),
+    sq_mask_(NULL), sq_array_(NULL), cq_head_(NULL), cq_tail_(NULL), cq_mask_(NULL), cqes_(NULL) {}
+
+LogSink::~LogSink() {
+  if (submitter_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    deferred_.notify_one();
+    submitter_.join();
+  }
+  if (sqes_ != NULL)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ != NULL && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != NULL)
+    munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ >= 0)
+    close(ring_fd_);
+}
+
+void LogSink::configure(const Json::Value& config) {
+  std::string sink = config.get("Log Sink", "writev").asString();
+  if (sink == "writev")
+    return;
+  if (sink != "io_uring") {
+    ROS_ERROR_STREAM("Unknown Log Sink " << sink << ", writing logs with writev");
+    return;
+  }
+#ifdef ROSMOD_ACTOR_IO_URING
+  if (ring_fd_ >= 0)
+    return;
+  if (setup_ring(256)) {
+    submitter_ = std::thread(&LogSink::run_submitter, this);
+    ROS_INFO_STREAM("Writing logs through io_uring");
+  }
+  else
+    ROS_WARN_STREAM("Couldn't set up io_uring (" << strerror(errno) <<
+		    "), writing logs with writev");
+#else
+  ROS_WARN_STREAM("Built without io_uring, writing logs with writev");
+#endif
+}
+
+// Write all buffers but the first skip bytes, however many writev() calls it
+// takes; iov is consumed
+bool LogSink::write_all(int fd, std::vector<struct iovec>& iov, size_t skip) {
+  size_t first = 0;
+  for (;;) {
+    for (; first < iov.size() && skip >= iov[first].iov_len; first++)
+      skip -= iov[first].iov_len;
+    if (first == iov.size())
+      return true;
+    iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + skip;
+    iov[first].iov_len -= skip;
+    int count = std::min<size_t>(iov.size() - first, IOV_MAX);
+    ssize_t written = writev(fd, &iov[first], count);
+    if (written < 0 && errno != EINTR)
+      return false;
+    if (written == 0) {
+      errno = EIO;
+      return false;
+    }
+    skip = std::max<ssize_t>(written, 0);
+  }
+}
+
+void LogSink::write(int fd, const struct iovec* iov, int count, LogWrite& write, bool defer) {
+  write.fd = fd;
+  write.iov.assign(iov, iov + count);
+  write.size = 0;
+  for (int i = 0; i < count; i++)
+    write.size += iov[i].iov_len;
+  write.finished = false;
+  write.result = 0;
+  if (ring_fd_ < 0) {
+    write.pending = false;
+    if (!write_all(fd, write.iov, 0))
+      ROS_ERROR_STREAM("Couldn't write log: " << strerror(errno));
+    return;
+  }
+#ifdef ROSMOD_ACTOR_IO_URING
+  bool submit;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    reap();
+    // keep room for every completion, and for the entry
+    while (inflight_ >= completions_ || unsubmitted() >= entries_) {
+      lock.unlock();
+      enter(entries_, 1);
+      lock.lock();
+      reap();
+    }
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & *sq_mask_;
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes_) + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->off = static_cast<uint64_t>(-1);  // the file position, which O_APPEND keeps at the end
+    sqe->addr = reinterpret_cast<uint64_t>(write.iov.data());
+    sqe->len = count;
+    sqe->user_data = reinterpret_cast<uint64_t>(&write);
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    inflight_++;
+    unsigned queued = unsubmitted();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (queued == 1)
+      deferred_since_ = now;
+    submit = !defer || queued >= kBatch || now - deferred_since_ >= kMaxDeferral;
+    if (!submit && queued == 1)
+      deferred_.notify_one();
+  }
+  write.pending = true;
+  // an entry left unsubmitted here goes with the next enter(), at the
+  // latest the submitter's
+  if (submit)
+    enter(entries_, 0);
+#endif
+}
+
+bool LogSink::done(LogWrite& write) {
+  if (!write.pending)
+    return true;
+  bool submit;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reap();
+    if (write.finished)
+      return true;
+    submit = unsubmitted() > 0 &&
+      std::chrono::steady_clock::now() - deferred_since_ >= kMaxDeferral;
+  }
+  if (submit)
+    enter(entries_, 0);
+  return false;
+}
+
+bool LogSink::wait(LogWrite& write) {
+  if (!write.pending)
+    return true;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (reap(); !write.finished; reap()) {
+      lock.unlock();
+      enter(entries_, 1);
+      lock.lock();
+    }
+  }
+  write.pending = false;
+  if (write.result >= 0 && static_cast<size_t>(write.result) == write.size)
+    return true;
+  // finish a short write, or retry a failed one, synchronously
+  if (write_all(write.fd, write.iov, std::max<int64_t>(write.result, 0)))
+    return true;
+  ROS_ERROR_STREAM("Couldn't write log: " << strerror(errno));
+  return false;
+}
+
+// Submit deferred writes once the oldest has waited kMaxDeferral, for
+// loggers that don't write or check on their writes again
+void LogSink::run_submitter() {
+  Timeline::instance().name_thread("log sink");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (unsubmitted() == 0) {
+      deferred_.wait(lock);
+      continue;
+    }
+    std::chrono::steady_clock::time_point due = deferred_since_ + kMaxDeferral;
+    if (std::chrono::steady_clock::now() < due) {
+      deferred_.wait_until(lock, due);
+      continue;
+    }
+    lock.unlock();
+    int submitted = enter(entries_, 0);
+    lock.lock();
+    // don't spin on a ring refusing entries; wait() and write() retry too
+    if (submitted < 0)
+      deferred_.wait_for(lock, kMaxDeferral);
+  }
+}
+
+bool LogSink::setup_ring(unsigned entries) {
+#ifdef ROSMOD_ACTOR_IO_URING
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0)
+    return false;
+  // timed waits and writes at the file position
+  if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_RW_CUR_POS)) {
+    close(fd);
+    errno = ENOSYS;
+    return false;
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sq = mmap(NULL, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+		  IORING_OFF_SQ_RING);
+  void* cq = single ? sq : mmap(NULL, cq_ring_size_, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  void* sqes = mmap(NULL, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+		    IORING_OFF_SQES);
+  if (sq == MAP_FAILED || cq == MAP_FAILED || sqes == MAP_FAILED) {
+    int error = errno;
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqes_size_);
+    if (cq != MAP_FAILED && cq != sq)
+      munmap(cq, cq_ring_size_);
+    if (sq != MAP_FAILED)
+      munmap(sq, sq_ring_size_);
+    close(fd);
+    errno = error;
+    return false;
+  }
+  sq_ring_ = sq;
+  cq_ring_ = cq;
+  sqes_ = sqes;
+  char* sq_bytes = static_cast<char*>(sq);
+  char* cq_bytes = static_cast<char*>(cq);
+  sq_head_ = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq_bytes + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned*>(cq_bytes + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq_bytes + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq_bytes + params.cq_off.ring_mask);
+  cqes_ = cq_bytes + params.cq_off.cqes;
+  entries_ = params.sq_entries;
+  completions_ = params.cq_entries;
+  ring_fd_ = fd;
+  return true;
+#else
+  errno = ENOSYS;
+  return false;
+#endif
+}
+
+// Mark the completed writes finished; call with mutex_ held
+void LogSink::reap() {
+#ifdef ROSMOD_ACTOR_IO_URING
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  for (; head != tail; head++) {
+    struct io_uring_cqe* cqe = static_cast<struct io_uring_cqe*>(cqes_) + (head & *cq_mask_);
+    LogWrite* write = reinterpret_cast<LogWrite*>(cqe->user_data);
+    write->result = cqe->res;
+    write->finished = true;
+    inflight_--;
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+#endif
+}
+
+// Entries queued but not yet taken by the kernel
+unsigned LogSink::unsubmitted() const {
+#ifdef ROSMOD_ACTOR_IO_URING
+  return *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+#else
+  return 0;
+#endif
+}
+
+// Submit queued entries and wait for up to complete completions, for at most 1 ms
+// since another thread may reap the one awaited
+int LogSink::enter(unsigned submit, unsigned complete) {
+#ifdef ROSMOD_ACTOR_IO_URING
+  if (complete == 0)
+    return syscall(__NR_io_uring_enter, ring_fd_, submit, 0, 0, NULL, 0);
+  struct __kernel_timespec timeout;
+  timeout.tv_sec = 0;
+  timeout.tv_nsec = 1000000;
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = reinterpret_cast<uint64_t>(&timeout);
+  return syscall(__NR_io_uring_enter, ring_fd_, submit, complete,
+		 IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+#else
+  return -1;
+#endif
+}
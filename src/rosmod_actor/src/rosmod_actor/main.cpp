@@ -10,9 +10,27 @@
 #include <exception>      
 #include <cstdlib>        
 #include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <chrono>
+#include <unistd.h>
+#include <libgen.h>
+#include <sys/inotify.h>
+#include <map>
+#include <memory>
 #include <boost/thread.hpp>
 #include "rosmod_actor/component.hpp"
 #include "rosmod_actor/json.hpp"
+#include "rosmod_actor/log_sink.hpp"
+#include "rosmod_actor/binary_config.hpp"
+#include "rosmod_actor/mock_master.hpp"
+#include "rosmod_actor/numa_placement.hpp"
+#include "rosmod_actor/realtime_memory.hpp"
+#include "rosmod_actor/replay.hpp"
+#include "rosmod_actor/timeline.hpp"
+#include "rosmod_actor/timer_engine.hpp"
+#include "rosmod_actor/tracepoints.hpp"
 #include "pthread.h"
 #include "sched.h"
 #include <iostream>
@@ -23,28 +41,523 @@
 #include <signal.h>
 #include <ros/ros.h>
 #include <ros/xmlrpc_manager.h>
+#include <ros/master.h>
 
-std::vector<Component*> comp_instances;
+/**
+ * @brief A loaded deployment configuration.
+ *
+ * Components reference their configuration inside root, so a document is
+ * shared by the instances started from it and lives until the last of them
+ * is destroyed.
+ */
+struct ConfigDocument {
+  BinaryConfig binary;  /*!< Mapping a binary config's strings point into */
+  Json::Value root;     /*!< Deployment configuration */
+};
+
+/**
+ * @brief A component instance started by this actor.
+ */
+struct Instance {
+  std::string name;                          /*!< Instance "Name" */
+  const Json::Value* config;                 /*!< Its "Component Instances" entry */
+  std::shared_ptr<ConfigDocument> document;  /*!< Keeps config alive */
+  Component* component;                      /*!< Component object */
+  boost::thread* thread;                     /*!< Component executor thread */
+  int numa_node;                             /*!< NUMA node it runs on, or -1 */
+  bool retired;                              /*!< Stopped, but its thread didn't exit */
+};
+
+std::vector<Instance> instances;
+NumaPlacement numa;
+RealtimeMemory realtimeMemory;
+
+// Self-pipe: the signal handler writes the signal number, main() reads it
+int shutdown_pipe[2] = {-1, -1};
 
-void rosmod_actor_SigInt_handler(int sig) {
-  std::cout << "Received signal: " << sig << std::endl;
-  std::cout << "Destroying " << comp_instances.size() << " components!" << std::endl;
-  for (int i=0; i < comp_instances.size(); i++) {
-    delete comp_instances[i];
+void rosmod_actor_signal_handler(int sig) {
+  // Only async-signal-safe calls here; main() runs the actual shutdown
+  int saved_errno = errno;
+  unsigned char byte = static_cast<unsigned char>(sig);
+  if (write(shutdown_pipe[1], &byte, 1) < 0) {
+    // pipe full: a shutdown is already pending
   }
+  errno = saved_errno;
 }
 
-void componentThreadFunc(Component* compPtr)
+/**
+ * @brief Installs the signal handlers feeding the shutdown pipe.
+ *
+ * SIGINT / SIGTERM request shutdown and reset to the default action once
+ * triggered, so a second signal kills a shutdown that hangs. SIGHUP
+ * requests a config reload.
+ */
+bool installSignalHandlers() {
+  if (pipe2(shutdown_pipe, O_CLOEXEC | O_NONBLOCK) != 0)
+    return false;
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = rosmod_actor_signal_handler;
+  action.sa_flags = SA_RESETHAND | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  struct sigaction reload = action;
+  reload.sa_flags = SA_RESTART;
+  return sigaction(SIGINT, &action, NULL) == 0 &&
+    sigaction(SIGTERM, &action, NULL) == 0 &&
+    sigaction(SIGHUP, &reload, NULL) == 0;
+}
+
+/**
+ * @brief Loads a json or binary deployment configuration.
+ * @param[in] path path to the configuration file.
+ * @return the document, or NULL if it couldn't be loaded.
+ */
+std::shared_ptr<ConfigDocument> loadConfig(const std::string& path) {
+  std::shared_ptr<ConfigDocument> document(new ConfigDocument());
+  try {
+    if (BinaryConfig::is_binary(path)) {
+      if (!document->binary.load(path, document->root)) {
+        ROS_ERROR_STREAM("Couldn't load binary config file: " << path);
+        return NULL;
+      }
+    } else {
+      std::ifstream configuration(path, std::ifstream::binary);
+      configuration >> document->root;
+    }
+  } catch (std::exception& e) {
+    ROS_ERROR_STREAM( std::string("Exception caught trying to open / parse config file: ") << e.what() );
+    return NULL;
+  } catch ( ... ) {
+    ROS_ERROR_STREAM("Unhandled exception caught trying to open / parse config file!");
+    return NULL;
+  }
+  return document;
+}
+
+void componentThreadFunc(Component* compPtr, const std::string& name, int numaNode)
 {
+  if (!numa.bind_thread(numaNode))
+    ROS_ERROR_STREAM("Couldn't bind component thread to NUMA node " << numaNode <<
+		     ": " << strerror(errno));
+  realtimeMemory.prepare_thread();
+  PageFaults prepared = RealtimeMemory::thread_faults();
+  Timeline::instance().name_thread(name);
+  ROSMOD_TRACE1(startup_begin, name.c_str());
   compPtr->startUp();
+  ROSMOD_TRACE1(startup_end, name.c_str());
+  PageFaults started = RealtimeMemory::thread_faults();
+  StackUsage stack = RealtimeMemory::thread_stack();
+  ROS_INFO_STREAM("Component " << name << " stack: " << stack.size / 1024 << " KB, " <<
+		  stack.guard / 1024 << " KB guard, " << stack.resident / 1024 <<
+		  " KB resident after startup");
+  if (realtimeMemory.enabled())
+    ROS_INFO_STREAM("Component " << name << " startup took " <<
+		    started.major - prepared.major << " major and " <<
+		    started.minor - prepared.minor << " minor page faults");
   compPtr->process_queue();
+  stack = RealtimeMemory::thread_stack();
+  ROS_INFO_STREAM("Component " << name << " stack: " << stack.resident / 1024 <<
+		  " KB resident when stopped");
+  if (realtimeMemory.enabled()) {
+    PageFaults stopped = RealtimeMemory::thread_faults();
+    ROS_INFO_STREAM("Component " << name << " took " <<
+		    stopped.major - started.major << " major and " <<
+		    stopped.minor - started.minor << " minor page faults while running");
+  }
+}
+
+/**
+ * @brief Loads a component library and starts an instance on its own thread.
+ * @param[in] config the instance's entry in "Component Instances".
+ * @param[in] document the document config belongs to.
+ * @return false if the library couldn't be loaded.
+ */
+bool startInstance(const Json::Value& config,
+		   const std::shared_ptr<ConfigDocument>& document) {
+  std::string libraryLocation = config["Definition"].asString();
+  void *hndl = dlopen(libraryLocation.c_str(), RTLD_NOW);
+  if(hndl == NULL) {
+    std::cerr << dlerror() << std::endl;
+    return false;
+  }
+  void *mkr = dlsym(hndl, "maker");
+  if(mkr == NULL) {
+    std::cerr << dlerror() << std::endl;
+    return false;
+  }
+  // Allocate the component (queue, loggers) from its node's memory, then
+  // go back to the main thread's own policy
+  int numaNode = numa.place(config);
+  MemoryPolicy inherited;
+  bool preferred = numaNode >= 0 && NumaPlacement::save_memory(inherited) &&
+    NumaPlacement::prefer_memory(numaNode);
+  if (numaNode >= 0 && !preferred)
+    ROS_ERROR_STREAM("Couldn't prefer memory from NUMA node " << numaNode <<
+		     ": " << strerror(errno));
+  // maker() takes a non-const reference for compatibility; components bind
+  // it to a const reference into the document, which outlives them, so no copy
+  Component *comp_inst = ((Component *(*)(Json::Value&))(mkr))
+    (const_cast<Json::Value&>(config));
+  if (preferred && !NumaPlacement::restore_memory(inherited))
+    ROS_ERROR_STREAM("Couldn't restore the memory policy: " << strerror(errno));
+
+  Instance instance;
+  instance.name = config["Name"].asString();
+  instance.config = &config;
+  instance.document = document;
+  instance.component = comp_inst;
+  instance.retired = false;
+  instance.numa_node = numaNode;
+  ROSMOD_TRACE2(component_load, instance.name.c_str(), comp_inst);
+  // Create Component Thread, with its "Stack Size" and "Guard Size" if set
+  boost::thread::attributes attributes;
+  size_t stackSize = config.get("Stack Size",
+				static_cast<Json::UInt64>(realtimeMemory.stack_size())).asUInt64();
+  if (stackSize != 0)
+    attributes.set_stack_size(stackSize);
+  if (config.isMember("Guard Size") &&
+      pthread_attr_setguardsize(attributes.native_handle(), config["Guard Size"].asUInt64()) != 0)
+    ROS_ERROR_STREAM("Couldn't set the guard size of " << instance.name);
+  std::string name = instance.name;
+  instance.thread = new boost::thread(attributes, [comp_inst, name, numaNode]() {
+    componentThreadFunc(comp_inst, name, numaNode);
+  });
+  instances.push_back(instance);
+  return true;
+}
+
+/**
+ * @brief Stops one instance, joins its thread and destroys it.
+ *
+ * An instance whose thread misses the deadline can't be destroyed safely:
+ * its logs are flushed in place and it is kept, retired, for shutdownActor().
+ * @param[in] instance the instance to stop.
+ * @param[in] timeout time allowed for its thread to exit.
+ * @return false if the deadline was missed.
+ */
+bool stopInstance(Instance& instance, boost::chrono::milliseconds timeout) {
+  instance.component->stop();
+  if (!instance.thread->try_join_for(timeout)) {
+    ROS_ERROR_STREAM("Component " << instance.name << " did not stop in time");
+    instance.component->flush_logs();
+    instance.retired = true;
+    return false;
+  }
+  delete instance.thread;
+  delete instance.component;
+  instance.thread = NULL;
+  instance.component = NULL;
+  numa.release(instance.numa_node);
+  return true;
+}
+
+/**
+ * @brief Applies an updated configuration file to the running instances.
+ *
+ * Instances are matched by "Name". Those whose entry in "Component
+ * Instances" is unchanged keep running untouched; changed and removed ones
+ * are stopped and destroyed, then changed and added ones are started from
+ * the new document. Node settings such as name or priority need a restart.
+ * @param[in] path path to the configuration file.
+ * @param[in] timeout time allowed for each stopped instance to exit.
+ */
+void reloadConfig(const std::string& path, boost::chrono::milliseconds timeout) {
+  typedef boost::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  std::shared_ptr<ConfigDocument> document = loadConfig(path);
+  if (!document) {
+    ROS_ERROR_STREAM("Reload failed, keeping the running configuration");
+    return;
+  }
+  const Json::Value& config = document->root;
+  const Json::Value& entries = config["Component Instances"];
+
+  std::map<std::string, Json::ArrayIndex> entryByName;
+  for (Json::ArrayIndex i = 0; i < entries.size(); i++)
+    entryByName.insert(std::make_pair(entries[i]["Name"].asString(), i));
+
+  unsigned int unchanged = 0, stopped = 0, started = 0;
+  std::vector<bool> running(entries.size(), false);
+  for (unsigned int i = 0; i < instances.size(); i++) {
+    if (instances[i].retired)
+      continue;
+    std::map<std::string, Json::ArrayIndex>::const_iterator entry =
+      entryByName.find(instances[i].name);
+    if (entry != entryByName.end() && !running[entry->second] &&
+	entries[entry->second] == *instances[i].config) {
+      running[entry->second] = true;
+      unchanged++;
+      continue;
+    }
+    stopInstance(instances[i], timeout);
+    stopped++;
+  }
+  for (unsigned int i = 0; i < instances.size(); ) {
+    if (instances[i].component == NULL)
+      instances.erase(instances.begin() + i);
+    else
+      i++;
+  }
+  for (Json::ArrayIndex i = 0; i < entries.size(); i++) {
+    if (running[i])
+      continue;
+    if (startInstance(entries[i], document))
+      started++;
+    else
+      ROS_ERROR_STREAM("Couldn't start " << entries[i]["Name"]);
+  }
+
+  typedef boost::chrono::duration<double, boost::milli> Millis;
+  ROS_INFO_STREAM("Reloaded " << path << " in " << Millis(Clock::now() - start).count() <<
+		  " ms: " << unchanged << " unchanged, " << stopped << " stopped, " <<
+		  started << " started");
+}
+
+/**
+ * @brief Opens an inotify watch reporting writes to the config file.
+ *
+ * The directory is watched, as editors often replace the file by renaming.
+ * @return the inotify descriptor, or -1 on failure.
+ */
+int watchConfig(const std::string& path) {
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0)
+    return -1;
+  std::vector<char> dir(path.begin(), path.end());
+  dir.push_back('\0');
+  if (inotify_add_watch(fd, dirname(&dir[0]), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief Drains pending inotify events.
+ * @return true if any of them was for the named file.
+ */
+bool configChanged(int watchFd, const std::string& fileName) {
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  bool changed = false;
+  ssize_t length;
+  while ((length = read(watchFd, buffer, sizeof(buffer))) > 0) {
+    const struct inotify_event* event;
+    for (char* ptr = buffer; ptr < buffer + length;
+	 ptr += sizeof(struct inotify_event) + event->len) {
+      event = reinterpret_cast<const struct inotify_event*>(ptr);
+      if (event->len > 0 && fileName == event->name)
+	changed = true;
+    }
+  }
+  return changed;
+}
+
+/**
+ * @brief Serves reload requests until a shutdown signal arrives or ROS
+ *        shuts down.
+ *
+ * A reload is requested by SIGHUP or, if watchFd is valid, by a write to
+ * the config file.
+ * @return the signal number, or 0 if ROS was shut down some other way.
+ */
+int serveUntilShutdown(const std::string& configFile, int watchFd,
+		       boost::chrono::milliseconds timeout) {
+  std::vector<char> path(configFile.begin(), configFile.end());
+  path.push_back('\0');
+  std::string fileName = basename(&path[0]);
+  struct pollfd pfds[2];
+  pfds[0].fd = shutdown_pipe[0];
+  pfds[0].events = POLLIN;
+  pfds[1].fd = watchFd;  // ignored by poll() if negative
+  pfds[1].events = POLLIN;
+  while (ros::ok()) {
+    if (poll(pfds, 2, 100) <= 0)
+      continue;
+    unsigned char sig;
+    if ((pfds[0].revents & POLLIN) && read(shutdown_pipe[0], &sig, 1) == 1) {
+      if (sig != SIGHUP)
+	return sig;
+      ROS_INFO_STREAM("Received SIGHUP, reloading " << configFile);
+      reloadConfig(configFile, timeout);
+    }
+    if ((pfds[1].revents & POLLIN) && configChanged(watchFd, fileName)) {
+      ROS_INFO_STREAM(configFile << " changed, reloading");
+      reloadConfig(configFile, timeout);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Stops all components, writes out their logs and joins them.
+ *
+ * The stages run in order:
+ *   stop  - shut down the ROS node, the timer engine and every component
+ *           queue,
+ *   join  - wait for the component threads to leave process_queue(),
+ *   flush - destroy the stopped components in parallel, writing their logs.
+ * Join and flush each get their own deadline, so one stuck component can't
+ * keep the others' logs from being written. Components whose thread misses
+ * the deadline are not destroyed; their logs are flushed in place. The time
+ * spent in each stage is reported.
+ * @param[in] timeout time allowed for each of the join and flush stages.
+ * @return false if a deadline was missed.
+ */
+bool shutdownActor(boost::chrono::milliseconds timeout) {
+  typedef boost::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  bool clean = true;
+  ROSMOD_TRACE1(shutdown_begin, instances.size());
+
+  ros::shutdown();
+  for (unsigned int i = 0; i < instances.size(); i++)
+    instances[i].component->stop();
+  TimerEngine::instance().stop();
+  Clock::time_point stopped = Clock::now();
+
+  Clock::time_point deadline = stopped + timeout;
+  std::vector<bool> joined(instances.size());
+  for (unsigned int i = 0; i < instances.size(); i++) {
+    joined[i] = instances[i].thread->try_join_until(deadline);
+    if (!joined[i]) {
+      ROS_ERROR_STREAM("Component " << instances[i].name << " did not stop in time");
+      clean = false;
+    }
+  }
+  Clock::time_point joinedAll = Clock::now();
+
+  deadline = joinedAll + timeout;
+  std::vector<boost::thread*> flushThreads;
+  for (unsigned int i = 0; i < instances.size(); i++) {
+    Component* comp = instances[i].component;
+    if (joined[i]) {
+      delete instances[i].thread;
+      flushThreads.push_back(new boost::thread([comp]() { delete comp; }));
+    }
+    else {
+      flushThreads.push_back(new boost::thread(&Component::flush_logs, comp));
+    }
+  }
+  for (unsigned int i = 0; i < flushThreads.size(); i++) {
+    if (flushThreads[i]->try_join_until(deadline)) {
+      delete flushThreads[i];
+    } else {
+      ROS_ERROR_STREAM("Log flush for component " << instances[i].name << " did not finish in time");
+      clean = false;
+    }
+  }
+  // Documents may only go once no component can still be using them
+  if (clean)
+    instances.clear();
+  Clock::time_point flushed = Clock::now();
+  ROSMOD_TRACE1(shutdown_end, clean);
+
+  typedef boost::chrono::duration<double, boost::milli> Millis;
+  ROS_INFO_STREAM("Shutdown took " << Millis(flushed - start).count() << " ms" <<
+		  " (stop " << Millis(stopped - start).count() << " ms" <<
+		  ", join " << Millis(joinedAll - stopped).count() << " ms" <<
+		  ", flush " << Millis(flushed - joinedAll).count() << " ms)");
+  return clean;
 }
 
-std::vector<boost::thread*> compThreads;	
+/**
+ * @brief Replays recorded events into the running components.
+ *
+ * Each event is queued on its target component (or all components) at its
+ * recorded offset from the first event divided by speed, or back to back if
+ * speed is 0. Returns once every component has handled its events.
+ * @param[in] events recorded events, sorted by stamp.
+ * @param[in] speed replay speed relative to the recording.
+ * @return the signal number if a shutdown signal interrupted the replay, or 0.
+ */
+int runReplay(const std::vector<ReplayEvent>& events, double speed) {
+  typedef std::chrono::steady_clock Clock;
+  struct pollfd pfd;
+  pfd.fd = shutdown_pipe[0];
+  pfd.events = POLLIN;
+  Clock::time_point start = Clock::now();
+  for (unsigned int i = 0; i <= events.size(); i++) {
+    Clock::time_point due = start;
+    if (i < events.size() && speed > 0)
+      due += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::nano>
+	((events[i].stamp - events.front().stamp) / speed));
+    bool idle = false;
+    while (!idle) {
+      // after the last event, wait for the queues to drain instead
+      Clock::time_point now = Clock::now();
+      if (i < events.size() && now >= due)
+	break;
+      std::chrono::nanoseconds wait = i < events.size() ? due - now :
+	std::chrono::nanoseconds(std::chrono::milliseconds(1));
+      struct timespec timeout;
+      timeout.tv_sec = wait.count() / 1000000000;
+      timeout.tv_nsec = wait.count() % 1000000000;
+      unsigned char sig;
+      if (ppoll(&pfd, 1, &timeout, NULL) > 0 && read(shutdown_pipe[0], &sig, 1) == 1 &&
+	  sig != SIGHUP)
+	return sig;
+      if (!ros::ok())
+	return 0;
+      if (i == events.size()) {
+	idle = true;
+	for (unsigned int j = 0; j < instances.size(); j++)
+	  idle = idle && instances[j].component->replay_idle();
+      }
+    }
+    if (i == events.size())
+      break;
+    for (unsigned int j = 0; j < instances.size(); j++) {
+      if (!instances[j].retired &&
+	  (events[i].component.empty() || events[i].component == instances[j].name))
+	instances[j].component->replay(events[i], due);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Writes the replay timings of every component as JSON.
+ * @param[in] path file to write to, or empty for stdout.
+ * @param[in] log replay log the events came from.
+ * @param[in] speed replay speed.
+ * @param[in] eventCount number of events replayed.
+ * @param[in] durationMs wall time the replay took.
+ */
+void writeReplayReport(const std::string& path, const std::string& log, double speed,
+		       size_t eventCount, double durationMs) {
+  Json::Value report;
+  report["log"] = log;
+  report["speed"] = speed;
+  report["events"] = static_cast<Json::UInt64>(eventCount);
+  report["duration_ms"] = durationMs;
+  Json::Value& components = report["components"] = Json::Value(Json::objectValue);
+  for (unsigned int i = 0; i < instances.size(); i++) {
+    Json::Value& channels = components[instances[i].name] = Json::Value(Json::objectValue);
+    const std::map<std::string, ReplayStats>& stats = instances[i].component->replay_stats();
+    for (std::map<std::string, ReplayStats>::const_iterator it = stats.begin();
+	 it != stats.end(); ++it)
+      channels[it->first] = it->second.summary();
+  }
+
+  Json::StyledWriter writer;
+  if (path.empty()) {
+    std::cout << writer.write(report);
+  } else {
+    std::ofstream file(path.c_str());
+    if (!(file << writer.write(report)))
+      ROS_ERROR_STREAM("Couldn't write replay report " << path);
+  }
+}
 
 void printHelp() {
   ROS_INFO_STREAM("\nUsage:  rosmod_actor\n" <<
-		  "\t--config <json config file>\n" <<
+		  "\t--config <json or binary config file>\n" <<
+		  "\t--shutdown-timeout <seconds> (default 5)\n" <<
+		  "\t--watch-config (reload on changes; SIGHUP always reloads)\n" <<
+		  "\t--replay <replay log> (replay recorded events offline, then exit)\n" <<
+		  "\t--replay-speed <factor> (default 1; 0 replays back to back)\n" <<
+		  "\t--replay-report <json file> (default stdout)\n" <<
+		  "\t--mock-master (serve an in-process ROS master; no roscore needed)\n" <<
 		  "\t--help   (show this help and exit)");
 }
 
@@ -56,11 +569,29 @@ int main(int argc, char **argv)
 {
   std::string nodeName = "";
   std::string configFile = "";
+  double shutdownTimeout = 5.0;
+  bool watch = false;
+  std::string replayFile = "";
+  std::string replayReport = "";
+  double replaySpeed = 1.0;
+  bool useMockMaster = false;
 
   for(int i = 0; i < argc; i++)
   {
     if(!strcmp(argv[i], "--config"))
       configFile = argv[i+1];
+    if(!strcmp(argv[i], "--shutdown-timeout") && i + 1 < argc)
+      shutdownTimeout = atof(argv[i+1]);
+    if(!strcmp(argv[i], "--watch-config"))
+      watch = true;
+    if(!strcmp(argv[i], "--replay") && i + 1 < argc)
+      replayFile = argv[i+1];
+    if(!strcmp(argv[i], "--replay-speed") && i + 1 < argc)
+      replaySpeed = atof(argv[i+1]);
+    if(!strcmp(argv[i], "--replay-report") && i + 1 < argc)
+      replayReport = argv[i+1];
+    if(!strcmp(argv[i], "--mock-master"))
+      useMockMaster = true;
     if(!strcmp(argv[i], "--help")) {
       printHelp();
       return 0;
@@ -74,25 +605,56 @@ int main(int argc, char **argv)
   }
 
 
-  Json::Value root;
-  try {
-    std::ifstream configuration(configFile, std::ifstream::binary);
-    configuration >> root;
-  } catch (std::exception& e) {
-    ROS_ERROR_STREAM( std::string("Exception caught trying to open / parse config file: ") << e.what() );
-  } catch ( ... ) {
-    ROS_ERROR_STREAM("Unhandled exception caught trying to open / parse config file!");
+  std::vector<ReplayEvent> replayEvents;
+  if (replayFile.length() && !ReplayLog::read(replayFile, replayEvents)) {
+    ROS_ERROR_STREAM("Couldn't load replay log: " << replayFile);
+    return 1;
   }
 
-  nodeName = root["Name"].asString();
-  ros::init(argc, argv, nodeName.c_str(), ros::init_options::NoSigintHandler);
-  signal(SIGINT, rosmod_actor_SigInt_handler);
+  std::shared_ptr<ConfigDocument> document = loadConfig(configFile);
+  if (!document)
+    document.reset(new ConfigDocument());
+
+  // Read-only view: const operator[] never inserts into the document
+  const Json::Value& config = document->root;
+  const Json::Value& entries = config["Component Instances"];
+
+  nodeName = config["Name"].asString();
+  MockMaster mockMaster;
+  if (useMockMaster) {
+    if (!mockMaster.start()) {
+      ROS_ERROR_STREAM("Couldn't start the mock master");
+      return 1;
+    }
+    // roscpp reads the master URI in ros::init()
+    setenv("ROS_MASTER_URI", mockMaster.uri().c_str(), 1);
+    ROS_INFO_STREAM("Serving mock master at " << mockMaster.uri());
+  }
+  uint32_t initOptions = ros::init_options::NoSigintHandler;
+  if (replayFile.length()) {
+    // Replay runs without a live ROS graph: don't block waiting for a master
+    initOptions |= ros::init_options::NoRosout;
+    ros::master::setRetryTimeout(ros::WallDuration(1.0));
+  }
+  ros::init(argc, argv, nodeName.c_str(), initOptions);
+  if (!installSignalHandlers())
+    ROS_ERROR_STREAM("Couldn't install signal handlers: " << strerror(errno));
 
-  ROS_INFO_STREAM( std::string("Root Node name: ") << root["Name"].asString() << std::endl);
-  ROS_INFO_STREAM( std::string("Root Node priority: ") << root["Priority"].asInt() << std::endl);
+  ROS_INFO_STREAM( std::string("Root Node name: ") << config["Name"].asString() << std::endl);
+  ROS_INFO_STREAM( std::string("Root Node priority: ") << config["Priority"].asInt() << std::endl);
 
   // Create Node Handle
   ros::NodeHandle n;
+
+  if (replayFile.length()) {
+    // Freeze ROS time at the start of the recording and hold the timer
+    // engine: component timers then only fire when their recorded ticks
+    // are replayed
+    ros::Time start;
+    start.fromNSec(replayEvents.empty() ? 1 : replayEvents.front().stamp);
+    ros::Time::setNow(start);
+    TimerEngine::instance().set_enabled(false);
+  }
   ROS_INFO_STREAM(nodeName << " thread id = " << boost::this_thread::get_id());
 
   int ret;
@@ -101,7 +663,7 @@ int main(int argc, char **argv)
   // struct sched_param is used to store the scheduling priority
   struct sched_param params;     
   // We'll set the priority to the maximum.
-  params.sched_priority = root["Priority"].asInt();  
+  params.sched_priority = config["Priority"].asInt();  
   if (params.sched_priority < 0)
     params.sched_priority = sched_get_priority_max(SCHED_RR);
 
@@ -126,26 +688,44 @@ int main(int argc, char **argv)
   // Print thread scheduling priority     
   ROS_INFO_STREAM("Thread priority is " << params.sched_priority << std::endl);
     
-  for (unsigned int i = 0; i < root["Component Instances"].size(); i++) {
-    std::string libraryLocation = root["Component Instances"][i]["Definition"].asString();
-    void *hndl = dlopen(libraryLocation.c_str(), RTLD_NOW);
-    if(hndl == NULL) {
-      std::cerr << dlerror() << std::endl;
+  Timeline::instance().configure(config);
+  LogSink::instance().configure(config);
+  realtimeMemory.configure(config);
+  if (!realtimeMemory.lock())
+    ROS_ERROR_STREAM("Couldn't lock memory: " << strerror(errno));
+  numa.configure(config);
+  for (unsigned int i = 0; i < entries.size(); i++) {
+    if (!startInstance(entries[i], document))
       exit(-1);
-    }
-    void *mkr = dlsym(hndl, "maker");
-    Component *comp_inst = ((Component *(*)(Json::Value&))(mkr))
-      (root["Component Instances"][i]);
+    ROS_INFO_STREAM(nodeName << " has started " << entries[i]["Name"]);
+  }
+  numa.report();
 
-    comp_instances.push_back(comp_inst);
-    
-    // Create Component Threads
-    boost::thread *comp_thread = new boost::thread(componentThreadFunc, comp_inst);
-    compThreads.push_back(comp_thread);
-    ROS_INFO_STREAM(nodeName << " has started " << root["Component Instances"][i]["Name"]);
+  boost::chrono::milliseconds timeout(static_cast<long>(shutdownTimeout * 1000));
+  int watchFd = -1;
+  if (watch && (watchFd = watchConfig(configFile)) < 0)
+    ROS_ERROR_STREAM("Couldn't watch " << configFile << ": " << strerror(errno));
+  int sig;
+  if (replayFile.length()) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sig = runReplay(replayEvents, replaySpeed);
+    if (sig == 0)
+      writeReplayReport(replayReport, replayFile, replaySpeed, replayEvents.size(),
+			std::chrono::duration<double, std::milli>
+			(std::chrono::steady_clock::now() - start).count());
+  } else {
+    sig = serveUntilShutdown(configFile, watchFd, timeout);
   }
-  for (int i=0;i<compThreads.size();i++) {
-    compThreads[i]->join();
+  if (sig != 0)
+    ROS_INFO_STREAM("Received signal: " << sig);
+  ROS_INFO_STREAM("Destroying " << instances.size() << " components!");
+  bool clean = shutdownActor(timeout);
+  Timeline::instance().write();
+  if (!clean) {
+    // Stuck component threads would still run during static destruction
+    std::cout.flush();
+    std::cerr.flush();
+    _exit(EXIT_FAILURE);
   }
   return 0; 
 }
@@ -0,0 +1,563 @@
+/** @file    mock_master.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the MockMaster class
+ */
+
+#include "rosmod_actor/mock_master.hpp"
+#include <sstream>
+#include <unistd.h>
+
+#include "ros/ros.h"
+#include "ros/network.h"
+
+namespace {
+
+const char* const kCallerId = "/master";
+
+void respond(XmlRpc::XmlRpcValue& result, int code, const std::string& status,
+	     const XmlRpc::XmlRpcValue& value) {
+  result[0] = code;
+  result[1] = status;
+  result[2] = value;
+}
+
+XmlRpc::XmlRpcValue empty_struct() {
+  int offset = 0;
+  return XmlRpc::XmlRpcValue("<value><struct></struct></value>", &offset);
+}
+
+bool starts_with(const std::string& str, const std::string& prefix) {
+  return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+std::string child_prefix(const std::string& key) {
+  return key == "/" ? key : key + "/";
+}
+
+// Is one of the keys the other or one of its ancestors?
+bool related(const std::string& a, const std::string& b) {
+  return a == b || starts_with(a, child_prefix(b)) || starts_with(b, child_prefix(a));
+}
+
+// Resolve a parameter key against the caller's namespace
+std::string resolve(const std::string& caller_id, const std::string& key) {
+  std::string resolved = key;
+  if (resolved.empty() || resolved[0] != '/')
+    resolved = caller_id.substr(0, caller_id.rfind('/')) + "/" + resolved;
+  while (resolved.size() > 1 && resolved[resolved.size() - 1] == '/')
+    resolved.erase(resolved.size() - 1);
+  return resolved;
+}
+
+}  // namespace
+
+/**
+ * @brief Master API method forwarding to a MockMaster member.
+ */
+class MockMaster::Method : public XmlRpc::XmlRpcServerMethod {
+public:
+  Method(const std::string& name, MockMaster* master, Handler handler)
+    : XmlRpc::XmlRpcServerMethod(name, &master->server_),
+      master_(master), handler_(handler) {}
+
+  virtual void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+    try {
+      (master_->*handler_)(params, result);
+    } catch (XmlRpc::XmlRpcException& e) {
+      respond(result, -1, e.getMessage(), XmlRpc::XmlRpcValue(0));
+    }
+  }
+
+private:
+  MockMaster* master_;
+  Handler handler_;
+};
+
+MockMaster::MockMaster()
+  : running_(false), server_thread_(NULL), notify_thread_(NULL) {
+  const struct {
+    const char* name;
+    Handler handler;
+  } methods[] = {
+    {"registerPublisher", &MockMaster::register_publisher},
+    {"unregisterPublisher", &MockMaster::unregister_publisher},
+    {"registerSubscriber", &MockMaster::register_subscriber},
+    {"unregisterSubscriber", &MockMaster::unregister_subscriber},
+    {"registerService", &MockMaster::register_service},
+    {"unregisterService", &MockMaster::unregister_service},
+    {"lookupService", &MockMaster::lookup_service},
+    {"lookupNode", &MockMaster::lookup_node},
+    {"getPublishedTopics", &MockMaster::get_published_topics},
+    {"getTopicTypes", &MockMaster::get_topic_types},
+    {"getSystemState", &MockMaster::get_system_state},
+    {"getUri", &MockMaster::get_uri},
+    {"getPid", &MockMaster::get_pid},
+    {"getParam", &MockMaster::get_param},
+    {"setParam", &MockMaster::set_param},
+    {"hasParam", &MockMaster::has_param},
+    {"deleteParam", &MockMaster::delete_param},
+    {"searchParam", &MockMaster::search_param},
+    {"subscribeParam", &MockMaster::subscribe_param},
+    {"unsubscribeParam", &MockMaster::unsubscribe_param},
+    {"getParamNames", &MockMaster::get_param_names},
+  };
+  for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++)
+    methods_.push_back(std::unique_ptr<Method>(new Method(methods[i].name, this,
+							    methods[i].handler)));
+}
+
+MockMaster::~MockMaster() {
+  stop();
+}
+
+bool MockMaster::start(int port) {
+  if (running_ || !server_.bindAndListen(port))
+    return false;
+  std::ostringstream uri;
+  uri << "http://127.0.0.1:" << server_.get_port() << "/";
+  uri_ = uri.str();
+  running_ = true;
+  server_thread_ = new boost::thread(&MockMaster::serve, this);
+  notify_thread_ = new boost::thread(&MockMaster::notify, this);
+  return true;
+}
+
+void MockMaster::stop() {
+  if (!running_)
+    return;
+  {
+    boost::lock_guard<boost::mutex> lock(notify_mutex_);
+    running_ = false;
+    notifications_.clear();
+  }
+  notify_cond_.notify_all();
+  server_thread_->join();
+  notify_thread_->join();
+  delete server_thread_;
+  delete notify_thread_;
+  server_thread_ = notify_thread_ = NULL;
+  server_.shutdown();
+}
+
+const std::string& MockMaster::uri() const {
+  return uri_;
+}
+
+void MockMaster::serve() {
+  while (running_)
+    server_.work(0.1);
+}
+
+// Make the queued calls to nodes, in order
+void MockMaster::notify() {
+  boost::unique_lock<boost::mutex> lock(notify_mutex_);
+  while (running_) {
+    if (notifications_.empty()) {
+      notify_cond_.wait(lock);
+      continue;
+    }
+    Notification notification = notifications_.front();
+    notifications_.pop_front();
+    lock.unlock();
+
+    std::string host;
+    uint32_t port;
+    XmlRpc::XmlRpcValue result;
+    if (!ros::network::splitURI(notification.api, host, port)) {
+      ROS_WARN_STREAM("Mock master: bad node URI " << notification.api);
+    } else {
+      XmlRpc::XmlRpcClient client(host.c_str(), port, "/");
+      if (!client.execute(notification.method.c_str(), notification.params, result))
+	ROS_WARN_STREAM("Mock master: " << notification.method << " to " <<
+			notification.api << " failed");
+      client.close();
+    }
+    lock.lock();
+  }
+}
+
+void MockMaster::enqueue(const std::string& api, const std::string& method,
+			 const XmlRpc::XmlRpcValue& params) {
+  Notification notification;
+  notification.api = api;
+  notification.method = method;
+  notification.params = params;
+  {
+    boost::lock_guard<boost::mutex> lock(notify_mutex_);
+    notifications_.push_back(notification);
+  }
+  notify_cond_.notify_one();
+}
+
+namespace {
+
+const std::vector<MockMaster::Registration>& find(const MockMaster::Registrations& registrations,
+						 const std::string& name) {
+  static const std::vector<MockMaster::Registration> none;
+  MockMaster::Registrations::const_iterator it = registrations.find(name);
+  return it == registrations.end() ? none : it->second;
+}
+
+XmlRpc::XmlRpcValue apis(const std::vector<MockMaster::Registration>& registrations) {
+  XmlRpc::XmlRpcValue list;
+  list.setSize(registrations.size());
+  for (size_t i = 0; i < registrations.size(); i++)
+    list[i] = registrations[i].api;
+  return list;
+}
+
+void add(MockMaster::Registrations& registrations, const std::string& name,
+	 const std::string& node, const std::string& api) {
+  std::vector<MockMaster::Registration>& entries = registrations[name];
+  for (size_t i = 0; i < entries.size(); i++)
+    if (entries[i].api == api)
+      return;
+  MockMaster::Registration registration;
+  registration.node = node;
+  registration.api = api;
+  entries.push_back(registration);
+}
+
+bool remove(MockMaster::Registrations& registrations, const std::string& name,
+	    const std::string& api) {
+  MockMaster::Registrations::iterator it = registrations.find(name);
+  if (it == registrations.end())
+    return false;
+  bool removed = false;
+  for (size_t i = it->second.size(); i-- > 0; ) {
+    if (it->second[i].api == api) {
+      it->second.erase(it->second.begin() + i);
+      removed = true;
+    }
+  }
+  if (it->second.empty())
+    registrations.erase(it);
+  return removed;
+}
+
+// [[name, [node, ...]], ...]
+XmlRpc::XmlRpcValue state(const MockMaster::Registrations& registrations) {
+  XmlRpc::XmlRpcValue list;
+  list.setSize(registrations.size());
+  int i = 0;
+  for (MockMaster::Registrations::const_iterator it = registrations.begin();
+       it != registrations.end(); ++it, i++) {
+    list[i][0] = it->first;
+    list[i][1].setSize(it->second.size());
+    for (size_t j = 0; j < it->second.size(); j++)
+      list[i][1][j] = it->second[j].node;
+  }
+  return list;
+}
+
+}  // namespace
+
+// Tell the subscribers of a topic about its current publishers
+void MockMaster::update_subscribers(const std::string& topic) {
+  XmlRpc::XmlRpcValue params;
+  params[0] = kCallerId;
+  params[1] = topic;
+  params[2] = apis(find(publishers_, topic));
+  const std::vector<Registration>& subscribers = find(subscribers_, topic);
+  for (size_t i = 0; i < subscribers.size(); i++)
+    enqueue(subscribers[i].api, "publisherUpdate", params);
+}
+
+// Send the new values of subscribed parameters affected by a change of key
+void MockMaster::update_param_subscribers(const std::string& key) {
+  for (Registrations::const_iterator it = param_subscribers_.begin();
+       it != param_subscribers_.end(); ++it) {
+    if (!related(it->first, key))
+      continue;
+    XmlRpc::XmlRpcValue params;
+    params[0] = kCallerId;
+    params[1] = it->first;
+    if (!get_param(it->first, params[2]))
+      params[2] = empty_struct();
+    for (size_t i = 0; i < it->second.size(); i++)
+      enqueue(it->second[i].api, "paramUpdate", params);
+  }
+}
+
+// Values of namespaces are assembled from the leaves below them
+bool MockMaster::get_param(const std::string& key, XmlRpc::XmlRpcValue& value) const {
+  std::map<std::string, XmlRpc::XmlRpcValue>::const_iterator it = params_.find(key);
+  if (it != params_.end()) {
+    value = it->second;
+    return true;
+  }
+  std::string prefix = child_prefix(key);
+  bool found = false;
+  for (it = params_.lower_bound(prefix);
+       it != params_.end() && starts_with(it->first, prefix); ++it) {
+    XmlRpc::XmlRpcValue* node = &value;
+    std::string rest = it->first.substr(prefix.size());
+    size_t slash;
+    while ((slash = rest.find('/')) != std::string::npos) {
+      node = &(*node)[rest.substr(0, slash)];
+      rest.erase(0, slash + 1);
+    }
+    (*node)[rest] = it->second;
+    found = true;
+  }
+  return found;
+}
+
+bool MockMaster::has_param(const std::string& key) const {
+  if (params_.count(key))
+    return true;
+  std::string prefix = child_prefix(key);
+  std::map<std::string, XmlRpc::XmlRpcValue>::const_iterator it = params_.lower_bound(prefix);
+  return it != params_.end() && starts_with(it->first, prefix);
+}
+
+// Dictionaries are stored as their leaves
+void MockMaster::set_param(const std::string& key, XmlRpc::XmlRpcValue& value) {
+  erase_param(key);
+  if (value.getType() == XmlRpc::XmlRpcValue::TypeStruct && value.size() > 0) {
+    for (XmlRpc::XmlRpcValue::iterator it = value.begin(); it != value.end(); ++it)
+      set_param(child_prefix(key) + it->first, it->second);
+  } else {
+    params_[key] = value;
+  }
+}
+
+void MockMaster::erase_param(const std::string& key) {
+  params_.erase(key);
+  std::string prefix = child_prefix(key);
+  std::map<std::string, XmlRpc::XmlRpcValue>::iterator it = params_.lower_bound(prefix);
+  while (it != params_.end() && starts_with(it->first, prefix))
+    params_.erase(it++);
+}
+
+// registerPublisher(caller_id, topic, topic_type, caller_api)
+void MockMaster::register_publisher(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], topic = params[1], type = params[2], api = params[3];
+  nodes_[caller_id] = api;
+  topic_types_[topic] = type;
+  add(publishers_, topic, caller_id, api);
+  update_subscribers(topic);
+  respond(result, 1, "Registered [" + caller_id + "] as publisher of [" + topic + "]",
+	  apis(find(subscribers_, topic)));
+}
+
+// unregisterPublisher(caller_id, topic, caller_api)
+void MockMaster::unregister_publisher(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], topic = params[1], api = params[2];
+  bool removed = remove(publishers_, topic, api);
+  if (removed)
+    update_subscribers(topic);
+  respond(result, 1, "Unregistered [" + caller_id + "] as publisher of [" + topic + "]",
+	  XmlRpc::XmlRpcValue(removed ? 1 : 0));
+}
+
+// registerSubscriber(caller_id, topic, topic_type, caller_api)
+void MockMaster::register_subscriber(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], topic = params[1], type = params[2], api = params[3];
+  nodes_[caller_id] = api;
+  if (type != "*" && !topic_types_.count(topic))
+    topic_types_[topic] = type;
+  add(subscribers_, topic, caller_id, api);
+  respond(result, 1, "Subscribed [" + caller_id + "] to [" + topic + "]",
+	  apis(find(publishers_, topic)));
+}
+
+// unregisterSubscriber(caller_id, topic, caller_api)
+void MockMaster::unregister_subscriber(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], topic = params[1], api = params[2];
+  bool removed = remove(subscribers_, topic, api);
+  respond(result, 1, "Unsubscribed [" + caller_id + "] from [" + topic + "]",
+	  XmlRpc::XmlRpcValue(removed ? 1 : 0));
+}
+
+// registerService(caller_id, service, service_api, caller_api)
+void MockMaster::register_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], service = params[1];
+  std::string service_api = params[2], api = params[3];
+  nodes_[caller_id] = api;
+  Registration provider;
+  provider.node = caller_id;
+  provider.api = api;
+  services_[service] = std::make_pair(service_api, provider);
+  respond(result, 1, "Registered [" + caller_id + "] as provider of [" + service + "]",
+	  XmlRpc::XmlRpcValue(1));
+}
+
+// unregisterService(caller_id, service, service_api)
+void MockMaster::unregister_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], service = params[1], service_api = params[2];
+  std::map<std::string, std::pair<std::string, Registration> >::iterator it =
+    services_.find(service);
+  bool removed = it != services_.end() && it->second.first == service_api;
+  if (removed)
+    services_.erase(it);
+  respond(result, 1, "Unregistered [" + caller_id + "] as provider of [" + service + "]",
+	  XmlRpc::XmlRpcValue(removed ? 1 : 0));
+}
+
+// lookupService(caller_id, service)
+void MockMaster::lookup_service(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string service = params[1];
+  std::map<std::string, std::pair<std::string, Registration> >::const_iterator it =
+    services_.find(service);
+  if (it == services_.end())
+    respond(result, -1, "No provider for [" + service + "]", XmlRpc::XmlRpcValue(""));
+  else
+    respond(result, 1, "rosrpc URI: [" + it->second.first + "]",
+	    XmlRpc::XmlRpcValue(it->second.first));
+}
+
+// lookupNode(caller_id, node_name)
+void MockMaster::lookup_node(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string node = params[1];
+  std::map<std::string, std::string>::const_iterator it = nodes_.find(node);
+  if (it == nodes_.end())
+    respond(result, -1, "Unknown node [" + node + "]", XmlRpc::XmlRpcValue(""));
+  else
+    respond(result, 1, "node api", XmlRpc::XmlRpcValue(it->second));
+}
+
+// getPublishedTopics(caller_id, subgraph)
+void MockMaster::get_published_topics(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string subgraph = params[1];
+  XmlRpc::XmlRpcValue topics;
+  topics.setSize(0);
+  int i = 0;
+  for (Registrations::const_iterator it = publishers_.begin(); it != publishers_.end(); ++it) {
+    if (!starts_with(it->first, subgraph))
+      continue;
+    topics[i][0] = it->first;
+    topics[i][1] = topic_types_[it->first];
+    i++;
+  }
+  respond(result, 1, "current topics", topics);
+}
+
+// getTopicTypes(caller_id)
+void MockMaster::get_topic_types(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  XmlRpc::XmlRpcValue types;
+  types.setSize(topic_types_.size());
+  int i = 0;
+  for (std::map<std::string, std::string>::const_iterator it = topic_types_.begin();
+       it != topic_types_.end(); ++it, i++) {
+    types[i][0] = it->first;
+    types[i][1] = it->second;
+  }
+  respond(result, 1, "current topics", types);
+}
+
+// getSystemState(caller_id)
+void MockMaster::get_system_state(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  Registrations providers;
+  for (std::map<std::string, std::pair<std::string, Registration> >::const_iterator it =
+	 services_.begin(); it != services_.end(); ++it)
+    providers[it->first].push_back(it->second.second);
+  XmlRpc::XmlRpcValue system;
+  system[0] = state(publishers_);
+  system[1] = state(subscribers_);
+  system[2] = state(providers);
+  respond(result, 1, "current system state", system);
+}
+
+// getUri(caller_id)
+void MockMaster::get_uri(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  respond(result, 1, "", XmlRpc::XmlRpcValue(uri_));
+}
+
+// getPid(caller_id)
+void MockMaster::get_pid(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  respond(result, 1, "", XmlRpc::XmlRpcValue(static_cast<int>(getpid())));
+}
+
+// getParam(caller_id, key)
+void MockMaster::get_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string key = resolve(params[0], params[1]);
+  XmlRpc::XmlRpcValue value;
+  if (get_param(key, value))
+    respond(result, 1, "Parameter [" + key + "]", value);
+  else
+    respond(result, -1, "Parameter [" + key + "] is not set", XmlRpc::XmlRpcValue(0));
+}
+
+// setParam(caller_id, key, value)
+void MockMaster::set_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string key = resolve(params[0], params[1]);
+  set_param(key, params[2]);
+  update_param_subscribers(key);
+  respond(result, 1, "parameter [" + key + "] set", XmlRpc::XmlRpcValue(0));
+}
+
+// hasParam(caller_id, key)
+void MockMaster::has_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string key = resolve(params[0], params[1]);
+  respond(result, 1, key, XmlRpc::XmlRpcValue(has_param(key)));
+}
+
+// deleteParam(caller_id, key)
+void MockMaster::delete_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string key = resolve(params[0], params[1]);
+  if (!has_param(key)) {
+    respond(result, -1, "parameter [" + key + "] is not set", XmlRpc::XmlRpcValue(0));
+    return;
+  }
+  erase_param(key);
+  update_param_subscribers(key);
+  respond(result, 1, "parameter [" + key + "] deleted", XmlRpc::XmlRpcValue(0));
+}
+
+// searchParam(caller_id, key): look for the key's first name from the
+// caller's namespace up to the root
+void MockMaster::search_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], key = params[1];
+  if (!key.empty() && key[0] == '/') {
+    if (has_param(key))
+      respond(result, 1, "Found [" + key + "]", XmlRpc::XmlRpcValue(key));
+    else
+      respond(result, -1, "Cannot find parameter [" + key + "]", XmlRpc::XmlRpcValue(""));
+    return;
+  }
+  std::string head = key.substr(0, key.find('/'));
+  std::string tail = key.substr(head.size());
+  std::string ns = caller_id.substr(0, caller_id.rfind('/'));
+  while (true) {
+    if (has_param(ns + "/" + head)) {
+      respond(result, 1, "Found", XmlRpc::XmlRpcValue(ns + "/" + head + tail));
+      return;
+    }
+    if (ns.empty())
+      break;
+    ns.erase(ns.rfind('/'));
+  }
+  respond(result, -1, "Cannot find parameter [" + key + "]", XmlRpc::XmlRpcValue(""));
+}
+
+// subscribeParam(caller_id, caller_api, key)
+void MockMaster::subscribe_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], api = params[1];
+  std::string key = resolve(caller_id, params[2]);
+  add(param_subscribers_, key, caller_id, api);
+  XmlRpc::XmlRpcValue value;
+  if (!get_param(key, value))
+    value = empty_struct();
+  respond(result, 1, "Subscribed to parameter [" + key + "]", value);
+}
+
+// unsubscribeParam(caller_id, caller_api, key)
+void MockMaster::unsubscribe_param(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  std::string caller_id = params[0], api = params[1];
+  std::string key = resolve(caller_id, params[2]);
+  bool removed = remove(param_subscribers_, key, api);
+  respond(result, 1, "Unsubscribed from parameter [" + key + "]",
+	  XmlRpc::XmlRpcValue(removed ? 1 : 0));
+}
+
+// getParamNames(caller_id)
+void MockMaster::get_param_names(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result) {
+  XmlRpc::XmlRpcValue names;
+  names.setSize(params_.size());
+  int i = 0;
+  for (std::map<std::string, XmlRpc::XmlRpcValue>::const_iterator it = params_.begin();
+       it != params_.end(); ++it, i++)
+    names[i] = it->first;
+  respond(result, 1, "Parameter names", names);
+}
@@ -0,0 +1,182 @@
+/** @file    numa_placement.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the NUMA placement of component instances
+ */
+
+#include "rosmod_actor/numa_placement.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <fstream>
+#include <sstream>
+
+#include "ros/ros.h"
+
+namespace {
+
+const char* kNodeDir = "/sys/devices/system/node";
+const int kMaxNodes = MemoryPolicy::kMaxNodes;
+
+/**
+ * @brief Parses a sysfs cpulist such as "0-3,8-11".
+ */
+void parseCpuList(const std::string& list, cpu_set_t& cpus) {
+  CPU_ZERO(&cpus);
+  std::istringstream ranges(list);
+  std::string range;
+  while (std::getline(ranges, range, ',')) {
+    char* end;
+    long first = strtol(range.c_str(), &end, 10);
+    long last = *end == '-' ? strtol(end + 1, NULL, 10) : first;
+    for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+      if (cpu >= 0)
+	CPU_SET(cpu, &cpus);
+  }
+}
+
+/**
+ * @brief Reads a "Node <n> <key>: <value> kB" line of a node's meminfo.
+ * @return the value in kB, or -1 if missing.
+ */
+long long nodeMemInfo(int node, const std::string& key) {
+  std::ifstream meminfo((std::string(kNodeDir) + "/node" + std::to_string(node) +
+			 "/meminfo").c_str());
+  std::string line;
+  while (std::getline(meminfo, line)) {
+    size_t pos = line.find(key + ":");
+    if (pos != std::string::npos)
+      return strtoll(line.c_str() + pos + key.size() + 1, NULL, 10);
+  }
+  return -1;
+}
+
+}  // namespace
+
+NumaPlacement::NumaPlacement() : automatic_(false) {}
+
+void NumaPlacement::configure(const Json::Value& config) {
+  nodes_.clear();
+  automatic_ = config.get("NUMA Placement", "Off").asString() == "Auto";
+
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    ROS_ERROR_STREAM("Couldn't read the actor's CPU affinity: " << strerror(errno));
+    return;
+  }
+  DIR* dir = opendir(kNodeDir);
+  if (dir == NULL)
+    return;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    char* end;
+    if (strncmp(entry->d_name, "node", 4) != 0)
+      continue;
+    long id = strtol(entry->d_name + 4, &end, 10);
+    if (end == entry->d_name + 4 || *end != '\0' || id >= kMaxNodes)
+      continue;
+    std::ifstream cpulist((std::string(kNodeDir) + "/" + entry->d_name + "/cpulist").c_str());
+    std::string list;
+    std::getline(cpulist, list);
+    NumaNode node;
+    node.id = id;
+    node.instances = 0;
+    parseCpuList(list, node.cpus);
+    CPU_AND(&node.cpus, &node.cpus, &allowed);
+    // memory-only nodes and nodes outside the affinity mask can't run threads
+    if (CPU_COUNT(&node.cpus) > 0)
+      nodes_.push_back(node);
+  }
+  closedir(dir);
+  std::sort(nodes_.begin(), nodes_.end(), [](const NumaNode& a, const NumaNode& b) {
+    return a.id < b.id;
+  });
+  if (automatic_ && nodes_.size() < 2)
+    ROS_INFO_STREAM("Only " << nodes_.size() << " NUMA node available, not placing instances");
+}
+
+int NumaPlacement::place(const Json::Value& instance) {
+  NumaNode* chosen = NULL;
+  if (instance.isMember("NUMA Node")) {
+    int id = instance["NUMA Node"].asInt();
+    int index = find(id);
+    if (index < 0) {
+      ROS_ERROR_STREAM("NUMA node " << id << " of " << instance["Name"].asString() <<
+		       " has no CPUs available, not placing it");
+      return -1;
+    }
+    chosen = &nodes_[index];
+  } else if (automatic_ && nodes_.size() > 1) {
+    for (size_t i = 0; i < nodes_.size(); i++)
+      if (chosen == NULL || nodes_[i].instances < chosen->instances)
+	chosen = &nodes_[i];
+  }
+  if (chosen == NULL)
+    return -1;
+  chosen->instances++;
+  return chosen->id;
+}
+
+void NumaPlacement::release(int node) {
+  int index = find(node);
+  if (index >= 0 && nodes_[index].instances > 0)
+    nodes_[index].instances--;
+}
+
+void NumaPlacement::report() const {
+  unsigned int placed = 0;
+  for (size_t i = 0; i < nodes_.size(); i++)
+    placed += nodes_[i].instances;
+  if (placed == 0)
+    return;
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    const NumaNode& node = nodes_[i];
+    ROS_INFO_STREAM("NUMA node " << node.id << ": " << CPU_COUNT(&node.cpus) << " CPUs, " <<
+		    nodeMemInfo(node.id, "MemFree") / 1024 << " of " <<
+		    nodeMemInfo(node.id, "MemTotal") / 1024 << " MB free, " <<
+		    node.instances << " instances");
+  }
+}
+
+bool NumaPlacement::prefer_memory(int node) {
+  if (node < 0)
+    return true;
+  // preferred rather than bound: a full node falls back instead of failing
+  unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))];
+  memset(mask, 0, sizeof(mask));
+  mask[node / (8 * sizeof(unsigned long))] = 1UL << (node % (8 * sizeof(unsigned long)));
+  // the kernel reads one bit less than maxnode
+  return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, kMaxNodes + 1) == 0;
+}
+
+bool NumaPlacement::save_memory(MemoryPolicy& policy) {
+  memset(&policy, 0, sizeof(policy));
+  return syscall(SYS_get_mempolicy, &policy.mode, policy.nodes, kMaxNodes, NULL, 0) == 0;
+}
+
+bool NumaPlacement::restore_memory(const MemoryPolicy& policy) {
+  // the mode comes back with its flags, as set_mempolicy() takes it
+  return syscall(SYS_set_mempolicy, policy.mode, policy.nodes, kMaxNodes + 1) == 0;
+}
+
+bool NumaPlacement::bind_thread(int node) const {
+  if (node < 0)
+    return true;
+  int index = find(node);
+  if (index < 0)
+    return false;
+  return sched_setaffinity(0, sizeof(nodes_[index].cpus), &nodes_[index].cpus) == 0 &&
+    prefer_memory(node);
+}
+
+// Index of a node in nodes_, or -1
+int NumaPlacement::find(int node) const {
+  for (size_t i = 0; i < nodes_.size(); i++)
+    if (nodes_[i].id == node)
+      return i;
+  return -1;
+}
@@ -0,0 +1,120 @@
+/** @file    realtime_memory.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the actor's real-time memory mode
+ */
+
+#include "rosmod_actor/realtime_memory.hpp"
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <vector>
+
+namespace {
+
+// Stack left untouched below the touched part, for touchStack() itself
+const size_t kStackMargin = 16 * 1024;
+// Heap is reserved in chunks small enough to come from the malloc arena
+const size_t kHeapChunk = 64 * 1024;
+
+// A separate frame, so the touched stack is released on return
+void __attribute__((noinline)) touchStack(size_t bytes) {
+  volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+  size_t page = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < bytes; i += page)
+    stack[i] = 0;
+}
+
+}  // namespace
+
+RealtimeMemory::RealtimeMemory() : enabled_(false), stack_size_(0), heap_reserve_(0) {}
+
+void RealtimeMemory::configure(const Json::Value& config) {
+  const Json::Value& mode = config["Real-Time Memory"];
+  enabled_ = mode.isObject();
+  stack_size_ = enabled_ ? mode.get("Stack Size", 1024 * 1024).asUInt64() : 0;
+  heap_reserve_ = enabled_ ? mode.get("Heap Reserve", 8 * 1024 * 1024).asUInt64() : 0;
+  // not below what glibc needs for the thread's TLS and frames
+  if (enabled_ && stack_size_ < 64 * 1024)
+    stack_size_ = 64 * 1024;
+}
+
+bool RealtimeMemory::enabled() const {
+  return enabled_;
+}
+
+size_t RealtimeMemory::stack_size() const {
+  return stack_size_;
+}
+
+bool RealtimeMemory::lock() const {
+  if (!enabled_)
+    return true;
+  // keep freed memory in the heap instead of returning it to the system
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+  return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
+void RealtimeMemory::prepare_thread() const {
+  if (!enabled_)
+    return;
+  // touch the free part of the stack, below the current frame
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+    void* bottom;
+    size_t size;
+    pthread_attr_getstack(&attributes, &bottom, &size);
+    pthread_attr_destroy(&attributes);
+    char here;
+    size_t free_bytes = &here - static_cast<char*>(bottom);
+    if (free_bytes > 2 * kStackMargin)
+      touchStack(free_bytes - 2 * kStackMargin);
+  }
+  std::vector<char*> chunks;
+  chunks.reserve(heap_reserve_ / kHeapChunk);
+  for (size_t reserved = 0; reserved < heap_reserve_; reserved += kHeapChunk) {
+    char* chunk = static_cast<char*>(malloc(kHeapChunk));
+    if (chunk == NULL)
+      break;
+    memset(chunk, 0, kHeapChunk);
+    chunks.push_back(chunk);
+  }
+  for (size_t i = 0; i < chunks.size(); i++)
+    free(chunks[i]);
+}
+
+PageFaults RealtimeMemory::thread_faults() {
+  PageFaults faults = {0, 0};
+  struct rusage usage;
+  if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+    faults.minor = usage.ru_minflt;
+    faults.major = usage.ru_majflt;
+  }
+  return faults;
+}
+
+StackUsage RealtimeMemory::thread_stack() {
+  StackUsage stack = {0, 0, 0};
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+    return stack;
+  void* bottom;
+  pthread_attr_getstack(&attributes, &bottom, &stack.size);
+  pthread_attr_getguardsize(&attributes, &stack.guard);
+  pthread_attr_destroy(&attributes);
+
+  size_t page = sysconf(_SC_PAGESIZE);
+  uintptr_t start = reinterpret_cast<uintptr_t>(bottom) & ~(page - 1);
+  size_t pages = (reinterpret_cast<uintptr_t>(bottom) + stack.size - start + page - 1) / page;
+  std::vector<unsigned char> resident(pages);
+  if (mincore(reinterpret_cast<void*>(start), pages * page, &resident[0]) == 0)
+    for (size_t i = 0; i < pages; i++)
+      if (resident[i] & 1)
+	stack.resident += page;
+  return stack;
+}
@@ -0,0 +1,157 @@
+/** @file    replay.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the replay log and statistics
+ */
+
+#include "rosmod_actor/replay.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char kMagic[8] = {'R', 'M', 'O', 'D', 'R', 'P', 'L', '1'};
+
+void put_u32(std::ostream& out, uint32_t value) {
+  char bytes[4];
+  for (int i = 0; i < 4; i++)
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  out.write(bytes, sizeof(bytes));
+}
+
+void put_u64(std::ostream& out, uint64_t value) {
+  char bytes[8];
+  for (int i = 0; i < 8; i++)
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  out.write(bytes, sizeof(bytes));
+}
+
+void put_bytes(std::ostream& out, const void* data, size_t length) {
+  put_u32(out, static_cast<uint32_t>(length));
+  out.write(static_cast<const char*>(data), length);
+}
+
+/**
+ * @brief Bounds-checked cursor over a loaded log.
+ */
+class Cursor {
+public:
+  Cursor(const char* begin, const char* end) : current_(begin), end_(end) {}
+
+  bool at_end() const { return current_ == end_; }
+
+  bool get_u8(uint8_t& value) {
+    if (end_ - current_ < 1)
+      return false;
+    value = static_cast<uint8_t>(*current_++);
+    return true;
+  }
+
+  bool get_u32(uint32_t& value) {
+    if (end_ - current_ < 4)
+      return false;
+    value = 0;
+    for (int i = 0; i < 4; i++)
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(current_[i])) << (8 * i);
+    current_ += 4;
+    return true;
+  }
+
+  bool get_u64(uint64_t& value) {
+    if (end_ - current_ < 8)
+      return false;
+    value = 0;
+    for (int i = 0; i < 8; i++)
+      value |= static_cast<uint64_t>(static_cast<uint8_t>(current_[i])) << (8 * i);
+    current_ += 8;
+    return true;
+  }
+
+  template <class Container>
+  bool get_bytes(Container& value) {
+    uint32_t length;
+    if (!get_u32(length) || static_cast<uint64_t>(end_ - current_) < length)
+      return false;
+    value.assign(current_, current_ + length);
+    current_ += length;
+    return true;
+  }
+
+private:
+  const char* current_;
+  const char* end_;
+};
+
+bool earlier(const ReplayEvent& a, const ReplayEvent& b) {
+  return a.stamp < b.stamp;
+}
+
+Json::Value distribution(std::vector<double> samples) {
+  Json::Value result(Json::objectValue);
+  if (samples.empty())
+    return result;
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (size_t i = 0; i < samples.size(); i++)
+    sum += samples[i];
+  result["mean"] = sum / samples.size();
+  result["min"] = samples.front();
+  result["p50"] = samples[samples.size() * 50 / 100];
+  result["p90"] = samples[samples.size() * 90 / 100];
+  result["p99"] = samples[samples.size() * 99 / 100];
+  result["max"] = samples.back();
+  return result;
+}
+
+}  // namespace
+
+bool ReplayLog::read(const std::string& path, std::vector<ReplayEvent>& events) {
+  std::ifstream file(path.c_str(), std::ifstream::binary);
+  if (!file)
+    return false;
+  std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(kMagic) || memcmp(&data[0], kMagic, sizeof(kMagic)) != 0)
+    return false;
+
+  events.clear();
+  Cursor cursor(&data[0] + sizeof(kMagic), &data[0] + data.size());
+  while (!cursor.at_end()) {
+    ReplayEvent event;
+    uint8_t kind;
+    if (!cursor.get_u64(event.stamp) || !cursor.get_u8(kind) ||
+        kind > ReplayEvent::timer ||
+        !cursor.get_bytes(event.component) || !cursor.get_bytes(event.channel) ||
+        !cursor.get_bytes(event.payload))
+      return false;
+    event.kind = static_cast<ReplayEvent::Kind>(kind);
+    events.push_back(event);
+  }
+  std::stable_sort(events.begin(), events.end(), earlier);
+  return true;
+}
+
+bool ReplayLog::write_header(std::ostream& out) {
+  out.write(kMagic, sizeof(kMagic));
+  return static_cast<bool>(out);
+}
+
+bool ReplayLog::write(std::ostream& out, const ReplayEvent& event) {
+  put_u64(out, event.stamp);
+  out.put(static_cast<char>(event.kind));
+  put_bytes(out, event.component.data(), event.component.size());
+  put_bytes(out, event.channel.data(), event.channel.size());
+  put_bytes(out, event.payload.empty() ? NULL : &event.payload[0], event.payload.size());
+  return static_cast<bool>(out);
+}
+
+Json::Value ReplayStats::summary() const {
+  Json::Value result(Json::objectValue);
+  result["count"] = static_cast<Json::UInt64>(execution_us.size());
+  if (unhandled > 0)
+    result["unhandled"] = unhandled;
+  result["execution_us"] = distribution(execution_us);
+  result["delay_us"] = distribution(delay_us);
+  return result;
+}
@@ -0,0 +1,46 @@
+/** @file    shutdown_test_component.cpp
+ *  @date    October 2026
+ *  @brief   This file contains the dummy component driven by scripts/test_shutdown.py
+ */
+
+#include "rosmod_actor/component.hpp"
+#include <unistd.h>
+
+/**
+ * @brief Logs a numbered tick every 10 ms to <Name>.log in the working directory.
+ *
+ * Logs stay buffered until the component's logs are flushed, so the ticks
+ * only reach the file if shutdown writes them out. With "Stuck": true the
+ * fifth tick never returns, so the thread misses the shutdown deadline.
+ */
+class ShutdownTestComponent : public Component {
+public:
+  ShutdownTestComponent(const Json::Value& config) : Component(config), ticks_(0) {}
+
+  void startUp() {
+    logger->enable_logging();
+    logger->set_max_log_unit(1 << 20);
+    logger->create_file(workingDir + "/" + config["Name"].asString() + ".log");
+    add_periodic_timer("tick", 0.01, [this](const ros::TimerEvent&) {
+      tick();
+    });
+  }
+
+  void init_timer_operation(const ros::TimerEvent&) {}
+
+private:
+  void tick() {
+    logger->log("INFO", "tick %d", ++ticks_);
+    if (ticks_ == 5 && config.get("Stuck", false).asBool()) {
+      logger->log("INFO", "stuck");
+      for (;;)
+	sleep(1);
+    }
+  }
+
+  int ticks_;  /*!< Ticks logged */
+};
+
+extern "C" Component* maker(Json::Value& config) {
+  return new ShutdownTestComponent(config);
+}
@@ -0,0 +1,182 @@
+/** @file    structured_log.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the structured log formats
+ */
+
+#include "rosmod_actor/structured_log.hpp"
+#include "rosmod_actor/json.hpp"
+#include <string.h>
+
+namespace {
+
+const char kBlockMagic[] = "RMODLOG1";
+const size_t kBlockHeader = 8 + 4 + 4;
+
+void putUint(std::string& out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+void putText(std::string& out, const std::string& value) {
+  putUint(out, value.size(), 4);
+  out += value;
+}
+
+void putDouble(std::string& out, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putUint(out, bits, 8);
+}
+
+}  // namespace
+
+bool StructuredLog::parse(const std::string& name, Format& format) {
+  if (name == "Text")
+    format = text;
+  else if (name == "JSON")
+    format = json;
+  else if (name == "Columnar")
+    format = columnar;
+  else
+    return false;
+  return true;
+}
+
+void StructuredLog::append_text(std::string& out, const std::string& level, const std::string& time,
+				const std::string& message, std::initializer_list<LogField> fields) {
+  out += "ROSMOD::" + level + "::" + time + "::" + message;
+  for (const LogField& field : fields) {
+    out += ' ';
+    out += field.key;
+    out += '=';
+    switch (field.type) {
+    case LogField::integer: out += std::to_string(field.number); break;
+    case LogField::real: out += Json::valueToString(field.real_number); break;
+    case LogField::boolean: out += field.number ? "true" : "false"; break;
+    case LogField::text: out += field.string; break;
+    }
+  }
+  out += '\n';
+}
+
+void StructuredLog::append_json(std::string& out, const std::string& level, int64_t time,
+				const std::string& message, std::initializer_list<LogField> fields) {
+  out += "{\"time\":" + std::to_string(time) + ",\"level\":" +
+    Json::valueToQuotedString(level.c_str()) + ",\"message\":" +
+    Json::valueToQuotedString(message.c_str());
+  for (const LogField& field : fields) {
+    out += ',';
+    out += Json::valueToQuotedString(field.key);
+    out += ':';
+    switch (field.type) {
+    case LogField::integer: out += std::to_string(field.number); break;
+    case LogField::real: out += Json::valueToString(field.real_number); break;
+    case LogField::boolean: out += field.number ? "true" : "false"; break;
+    case LogField::text: out += Json::valueToQuotedString(field.string.c_str()); break;
+    }
+  }
+  out += "}\n";
+}
+
+ColumnarLog::ColumnarLog() : rows_(0), bytes_(kBlockHeader) {}
+
+// The column of a name and type, added if new
+ColumnarLog::Column& ColumnarLog::column(const char* name, LogField::Type type) {
+  for (size_t i = 0; i < columns_.size(); i++)
+    if (columns_[i].type == type && columns_[i].name == name)
+      return columns_[i];
+  Column added;
+  added.name = name;
+  added.type = type;
+  columns_.push_back(added);
+  return columns_.back();
+}
+
+void ColumnarLog::add(size_t row, const LogField& field) {
+  Column& target = column(field.key, field.type);
+  size_t before = target.values.size();
+  if (before == 0 && target.present.empty())
+    bytes_ += 2 + target.name.size() + 1;
+  target.present.resize(row / 8 + 1, 0);
+  target.present[row / 8] |= 1 << (row % 8);
+  switch (field.type) {
+  case LogField::integer: putUint(target.values, field.number, 8); break;
+  case LogField::real: putDouble(target.values, field.real_number); break;
+  case LogField::boolean: putUint(target.values, field.number, 1); break;
+  case LogField::text: putText(target.values, field.string); break;
+  }
+  bytes_ += target.values.size() - before;
+}
+
+void ColumnarLog::append(const std::string& level, int64_t time, const std::string& message,
+			 std::initializer_list<LogField> fields) {
+  size_t row = rows_++;
+  add(row, LogField("time", static_cast<long long>(time)));
+  add(row, LogField("level", level));
+  add(row, LogField("message", message));
+  for (const LogField& field : fields)
+    add(row, field);
+  if (row % 8 == 0)
+    bytes_ += columns_.size();  // bitmaps grow a byte every 8 rows
+}
+
+void ColumnarLog::serialize(std::string& out) {
+  std::string heads;
+  std::vector<struct iovec> iov;
+  gather(heads, iov);
+  out.reserve(out.size() + bytes_);
+  for (size_t i = 0; i < iov.size(); i++)
+    out.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+  clear();
+}
+
+void ColumnarLog::gather(std::string& heads, std::vector<struct iovec>& iov) {
+  // the headers first, since heads may move while growing
+  size_t used = 0;
+  for (size_t i = 0; i < columns_.size(); i++)
+    used += !columns_[i].present.empty();
+  heads.clear();
+  heads.append(kBlockMagic, 8);
+  putUint(heads, rows_, 4);
+  putUint(heads, used, 4);
+  std::vector<size_t> ends;
+  for (size_t i = 0; i < columns_.size(); i++) {
+    Column& written = columns_[i];
+    if (written.present.empty())
+      continue;
+    putUint(heads, written.name.size(), 2);
+    heads += written.name;
+    putUint(heads, written.type, 1);
+    written.present.resize((rows_ + 7) / 8, 0);
+    ends.push_back(heads.size());
+  }
+  size_t start = 0, column = 0;
+  for (size_t i = 0; i < columns_.size(); i++) {
+    Column& written = columns_[i];
+    if (written.present.empty())
+      continue;
+    // a column's header follows the block header, or the previous column
+    size_t end = ends[column++];
+    struct iovec head = {&heads[start], end - start};
+    struct iovec present = {written.present.data(), written.present.size()};
+    struct iovec values = {&written.values[0], written.values.size()};
+    iov.push_back(head);
+    iov.push_back(present);
+    if (!written.values.empty())
+      iov.push_back(values);
+    start = end;
+  }
+  if (column == 0) {
+    struct iovec head = {&heads[0], heads.size()};
+    iov.push_back(head);
+  }
+}
+
+void ColumnarLog::clear() {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    columns_[i].present.clear();
+    columns_[i].values.clear();
+  }
+  rows_ = 0;
+  bytes_ = kBlockHeader;
+}
@@ -0,0 +1,182 @@
+/** @file    timeline.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the actor's execution timeline recorder
+ */
+
+#include "rosmod_actor/timeline.hpp"
+#include <algorithm>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "ros/ros.h"
+
+namespace {
+
+const size_t kExitedKept = 64;     // exited threads whose events are kept
+const size_t kFirstEvents = 64;    // events a ring starts with
+
+int64_t nanoseconds(Timeline::Clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+}  // namespace
+
+Timeline& Timeline::instance() {
+  static Timeline timeline;
+  return timeline;
+}
+
+Timeline::Timeline() : enabled_(false), capacity_(0), freed_(0) {}
+
+void Timeline::configure(const Json::Value& config) {
+  const Json::Value& timeline = config["Timeline"];
+  if (!timeline.isObject())
+    return;
+  path_ = timeline.get("File", "timeline.json").asString();
+  capacity_ = timeline.get("Events Per Thread", 65536).asUInt();
+  enabled_ = capacity_ > 0;
+}
+
+const char* Timeline::intern(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return names_.insert(Json::valueToQuotedString(name.c_str())).first->c_str();
+}
+
+void Timeline::name_thread(const std::string& name) {
+  if (!enabled())
+    return;
+  ThreadBuffer& local = buffer();
+  std::lock_guard<std::mutex> lock(local.mutex);
+  local.name = Json::valueToQuotedString(name.c_str());
+}
+
+void Timeline::span(const char* name, const char* category, Clock::time_point start,
+		    Clock::time_point end, const char* arg_name, int64_t arg) {
+  TimelineEvent event = {name, category, 'X', nanoseconds(start),
+			 nanoseconds(end) - nanoseconds(start), arg_name, arg};
+  record(event);
+}
+
+void Timeline::instant(const char* name, const char* category, Clock::time_point time,
+		       const char* arg_name, int64_t arg) {
+  TimelineEvent event = {name, category, 'i', nanoseconds(time), 0, arg_name, arg};
+  record(event);
+}
+
+// The calling thread's buffer, created on first use
+Timeline::ThreadBuffer& Timeline::buffer() {
+  static thread_local ThreadBuffer* local = NULL;
+  if (local == NULL) {
+    std::shared_ptr<ThreadBuffer> created(new ThreadBuffer());
+    created->tid = syscall(SYS_gettid);
+    created->name = "\"thread " + std::to_string(created->tid) + "\"";
+    created->recorded = 0;
+    created->exited = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers_.push_back(created);
+    }
+    local = created.get();
+    static thread_local ThreadExit thread_exit = {&local};
+    (void)thread_exit;
+  }
+  return *local;
+}
+
+Timeline::ThreadExit::~ThreadExit() {
+  if (*local != NULL)
+    Timeline::instance().release(*local);
+  *local = NULL;
+}
+
+// Mark an exited thread's buffer, and free the oldest exited buffers past
+// kExitedKept
+void Timeline::release(ThreadBuffer* buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  {
+    std::lock_guard<std::mutex> thread_lock(buffer->mutex);
+    buffer->exited = true;
+  }
+  size_t exited = 0;
+  for (size_t i = 0; i < buffers_.size(); i++)
+    exited += buffers_[i]->exited;
+  for (size_t i = 0; i < buffers_.size() && exited > kExitedKept; ) {
+    if (buffers_[i]->exited) {
+      freed_ += buffers_[i]->recorded;
+      buffers_.erase(buffers_.begin() + i);
+      exited--;
+    } else {
+      i++;
+    }
+  }
+}
+
+void Timeline::record(const TimelineEvent& event) {
+  if (capacity_ == 0)
+    return;
+  ThreadBuffer& local = buffer();
+  std::lock_guard<std::mutex> lock(local.mutex);
+  std::vector<TimelineEvent>& events = local.events;
+  if (events.size() < capacity_ && local.recorded == events.size()) {
+    // grow the ring until it is full, never past capacity_
+    if (events.size() == events.capacity())
+      events.reserve(std::min(capacity_, std::max(kFirstEvents, 2 * events.size())));
+    events.push_back(event);
+  } else {
+    events[local.recorded % events.size()] = event;
+  }
+  local.recorded++;
+}
+
+bool Timeline::write() {
+  if (!enabled())
+    return true;
+  FILE* file = fopen(path_.c_str(), "w");
+  if (file == NULL) {
+    ROS_ERROR_STREAM("Couldn't write timeline " << path_ << ": " << strerror(errno));
+    return false;
+  }
+  long pid = getpid();
+  uint64_t written = 0, dropped = 0;
+  fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  const char* separator = "\n";
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < buffers_.size(); i++) {
+    ThreadBuffer& thread = *buffers_[i];
+    std::lock_guard<std::mutex> thread_lock(thread.mutex);
+    fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%ld,"
+	    "\"args\":{\"name\":%s}}", separator, pid, thread.tid, thread.name.c_str());
+    separator = ",\n";
+    // oldest first; a full ring starts at the next slot to overwrite
+    size_t size = thread.events.size();
+    uint64_t first = thread.recorded > size ? thread.recorded - size : 0;
+    for (uint64_t n = first; n < thread.recorded; n++) {
+      const TimelineEvent& event = thread.events[n % size];
+      fprintf(file, ",\n{\"name\":%s,\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":%ld,\"tid\":%ld,"
+	      "\"ts\":%.3f", event.name, event.category, event.phase, pid, thread.tid,
+	      event.start_ns / 1e3);
+      if (event.phase == 'X')
+	fprintf(file, ",\"dur\":%.3f", event.duration_ns / 1e3);
+      else
+	fprintf(file, ",\"s\":\"t\"");
+      if (event.arg_name != NULL)
+	fprintf(file, ",\"args\":{\"%s\":%lld}", event.arg_name,
+		static_cast<long long>(event.arg));
+      fprintf(file, "}");
+    }
+    written += thread.recorded - first;
+    dropped += first;
+  }
+  fprintf(file, "\n]}\n");
+  bool failed = ferror(file);
+  if (fclose(file) != 0 || failed) {
+    ROS_ERROR_STREAM("Couldn't write timeline " << path_ << ": " << strerror(errno));
+    return false;
+  }
+  ROS_INFO_STREAM("Wrote " << written << " timeline events to " << path_ << " (" <<
+		  dropped << " overwritten, " << freed_ << " from exited threads freed)");
+  return true;
+}
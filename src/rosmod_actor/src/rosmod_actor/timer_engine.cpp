@@ -0,0 +1,349 @@
+/** @file    timer_engine.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the actor's periodic timer engine
+ */
+
+#include "rosmod_actor/timer_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Queue entry running one expiry of a timer on the component thread.
+ */
+class TimerTick : public ros::CallbackInterface {
+public:
+  TimerTick(const PeriodicTimerPtr& timer, std::chrono::steady_clock::time_point expected,
+	    const ros::Time& ros_expected)
+    : timer_(timer), expected_(expected), ros_expected_(ros_expected) {}
+
+  virtual CallResult call() {
+    if (timer_->cancelled)
+      return Success;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    timer_->stats.record(std::chrono::duration<double, std::micro>(start - expected_).count());
+    Timeline& timeline = Timeline::instance();
+
+    ros::TimerEvent event;
+    event.last_expected = timer_->last_expected;
+    event.last_real = timer_->last_real;
+    event.current_expected = ros_expected_;
+    event.current_real = ros::Time::now();
+    timer_->callback(event);
+    if (timeline.enabled())
+      timeline.span(timer_->timeline_name, "timer", start, std::chrono::steady_clock::now(),
+		    "lateness_ns", std::chrono::duration_cast<std::chrono::nanoseconds>
+		    (start - expected_).count());
+    timer_->last_expected = event.current_expected;
+    timer_->last_real = event.current_real;
+    return Success;
+  }
+
+private:
+  PeriodicTimerPtr timer_;
+  std::chrono::steady_clock::time_point expected_;
+  ros::Time ros_expected_;
+};
+
+std::chrono::steady_clock::time_point expiry(const PeriodicTimer& timer) {
+  return timer.start + timer.period * static_cast<int64_t>(timer.next);
+}
+
+}  // namespace
+
+TimerStats::TimerStats() : count(0), sum_us(0), min_us(0), max_us(0), last_us(0), overruns(0) {
+  std::fill(histogram, histogram + kBuckets, 0);
+}
+
+void TimerStats::record(double lateness_us) {
+  int bucket = 0;
+  if (lateness_us >= 1)
+    bucket = std::min(kBuckets - 1, 1 + static_cast<int>(std::log2(lateness_us)));
+  histogram[bucket]++;
+  if (count == 0 || lateness_us < min_us)
+    min_us = lateness_us;
+  if (count == 0 || lateness_us > max_us)
+    max_us = lateness_us;
+  sum_us += lateness_us;
+  last_us = lateness_us;
+  count++;
+}
+
+Json::Value TimerStats::summary() const {
+  Json::Value result(Json::objectValue);
+  result["count"] = static_cast<Json::UInt64>(count);
+  result["overruns"] = static_cast<Json::UInt64>(overruns);
+  if (count == 0)
+    return result;
+
+  // Percentiles are the upper bounds of their buckets
+  Json::Value& lateness = result["lateness_us"];
+  lateness["min"] = min_us;
+  lateness["mean"] = sum_us / count;
+  lateness["max"] = max_us;
+  const int percentiles[] = {50, 90, 99};
+  for (size_t p = 0; p < sizeof(percentiles) / sizeof(percentiles[0]); p++) {
+    uint64_t seen = 0;
+    int bucket = 0;
+    while (bucket < kBuckets - 1 &&
+	   (seen += histogram[bucket]) * 100 < count * percentiles[p])
+      bucket++;
+    std::string name = "p" + std::to_string(percentiles[p]);
+    lateness[name] = std::min(max_us, std::ldexp(1.0, bucket));
+  }
+
+  // [[upper bound in us, count], ...] of the non-empty buckets
+  Json::Value& buckets = result["histogram_us"] = Json::Value(Json::arrayValue);
+  for (int i = 0; i < kBuckets; i++) {
+    if (histogram[i] == 0)
+      continue;
+    Json::Value& entry = buckets.append(Json::Value(Json::arrayValue));
+    entry.append(std::ldexp(1.0, i));
+    entry.append(static_cast<Json::UInt64>(histogram[i]));
+  }
+  return result;
+}
+
+TimerEngine& TimerEngine::instance() {
+  static TimerEngine engine;
+  return engine;
+}
+
+TimerEngine::TimerEngine()
+  : enabled_(true), running_(false), timer_fd_(-1), wake_fd_(-1), thread_(NULL) {}
+
+TimerEngine::~TimerEngine() {
+  stop();
+}
+
+PeriodicTimerPtr TimerEngine::add(const std::string& name, std::chrono::nanoseconds period,
+				  const PeriodicTimer::Callback& callback,
+				  ros::CallbackQueueInterface* queue, uint64_t owner_id) {
+  PeriodicTimerPtr timer(new PeriodicTimer());
+  timer->name = name;
+  timer->timeline_name = Timeline::instance().intern(name);
+  timer->period = period;
+  timer->next = 1;
+  timer->callback = callback;
+  timer->queue = queue;
+  timer->owner_id = owner_id;
+  timer->cancelled = false;
+  timer->once = false;
+  timer->ros_start = ros::Time::now();
+  timer->start = std::chrono::steady_clock::now();
+
+  if (period.count() <= 0) {
+    ROS_ERROR_STREAM("Timer " << name << " needs a positive period");
+    return timer;
+  }
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (!start()) {
+    ROS_ERROR_STREAM("Couldn't start the timer engine: " << strerror(errno));
+    return timer;
+  }
+  schedule_.insert(std::make_pair(expiry(*timer), timer));
+  arm();
+  return timer;
+}
+
+PeriodicTimerPtr TimerEngine::add_once(const std::string& name,
+				       const PeriodicTimer::Callback& callback,
+				       ros::CallbackQueueInterface* queue, uint64_t owner_id) {
+  PeriodicTimerPtr timer(new PeriodicTimer());
+  timer->name = name;
+  timer->timeline_name = Timeline::instance().intern(name);
+  timer->period = std::chrono::nanoseconds(0);
+  timer->next = 1;
+  timer->callback = callback;
+  timer->queue = queue;
+  timer->owner_id = owner_id;
+  timer->cancelled = false;
+  timer->once = true;
+  timer->ros_start = ros::Time::now();
+  timer->start = std::chrono::steady_clock::now();
+
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (!start())
+    ROS_ERROR_STREAM("Couldn't start the timer engine: " << strerror(errno));
+  return timer;
+}
+
+void TimerEngine::expire_in(const PeriodicTimerPtr& timer, std::chrono::nanoseconds delay) {
+  // read the clocks outside the lock
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  ros::Time ros_now = ros::Time::now();
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (timer->cancelled || !running_)
+    return;
+  bool rearm = unschedule(timer);
+  timer->start = now;
+  timer->ros_start = ros_now;
+  timer->period = delay;
+  Schedule::iterator it = schedule_.insert(std::make_pair(expiry(*timer), timer));
+  // the timerfd only changes if this is now the earliest expiry
+  if (rearm || it == schedule_.begin())
+    arm();
+}
+
+void TimerEngine::disarm(const PeriodicTimerPtr& timer) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (unschedule(timer) && running_)
+    arm();
+}
+
+void TimerEngine::cancel(const PeriodicTimerPtr& timer) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  timer->cancelled = true;
+  unschedule(timer);
+  if (running_)
+    arm();
+}
+
+void TimerEngine::set_enabled(bool enabled) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  enabled_ = enabled;
+  if (running_)
+    arm();
+}
+
+void TimerEngine::stop() {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (!running_)
+      return;
+    running_ = false;
+    schedule_.clear();
+  }
+  wake();
+  thread_->join();
+  delete thread_;
+  thread_ = NULL;
+  close(timer_fd_);
+  close(wake_fd_);
+  timer_fd_ = wake_fd_ = -1;
+}
+
+// Start the engine thread if needed; called with mutex_ held
+bool TimerEngine::start() {
+  if (running_)
+    return true;
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (timer_fd_ < 0 || wake_fd_ < 0) {
+    int error = errno;
+    if (timer_fd_ >= 0)
+      close(timer_fd_);
+    if (wake_fd_ >= 0)
+      close(wake_fd_);
+    timer_fd_ = wake_fd_ = -1;
+    errno = error;
+    return false;
+  }
+  running_ = true;
+  thread_ = new boost::thread(&TimerEngine::run, this);
+  return true;
+}
+
+// Arm the timerfd at the earliest expiry, or disarm it; called with mutex_ held
+void TimerEngine::arm() {
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+  if (enabled_ && !schedule_.empty()) {
+    // steady_clock is CLOCK_MONOTONIC
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>
+      (schedule_.begin()->first.time_since_epoch()).count();
+    ns = std::max<int64_t>(ns, 1);  // zero would disarm
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+  }
+  timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+void TimerEngine::wake() {
+  uint64_t one = 1;
+  if (write(wake_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    ROS_ERROR_STREAM("Couldn't wake the timer engine: " << strerror(errno));
+}
+
+void TimerEngine::run() {
+  Timeline::instance().name_thread("timer engine");
+  struct pollfd fds[2];
+  fds[0].fd = timer_fd_;
+  fds[0].events = POLLIN;
+  fds[1].fd = wake_fd_;
+  fds[1].events = POLLIN;
+  while (true) {
+    if (poll(fds, 2, -1) < 0 && errno != EINTR) {
+      ROS_ERROR_STREAM("Timer engine stopped: " << strerror(errno));
+      return;
+    }
+    uint64_t count;
+    if (fds[0].revents & POLLIN && read(timer_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN)
+      ROS_ERROR_STREAM("Couldn't read the engine timer: " << strerror(errno));
+    if (fds[1].revents & POLLIN && read(wake_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN)
+      ROS_ERROR_STREAM("Couldn't read the engine wakeup: " << strerror(errno));
+
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (!running_)
+      return;
+    fire(std::chrono::steady_clock::now());
+    arm();
+  }
+}
+
+// Queue the callbacks of all due timers and reschedule them; called with
+// mutex_ held
+void TimerEngine::fire(std::chrono::steady_clock::time_point now) {
+  if (!enabled_)
+    return;
+  while (!schedule_.empty() && schedule_.begin()->first <= now) {
+    std::chrono::steady_clock::time_point expected = schedule_.begin()->first;
+    PeriodicTimerPtr timer = schedule_.begin()->second;
+    schedule_.erase(schedule_.begin());
+    ros::Time ros_expected;
+    ros_expected.fromNSec(timer->ros_start.toNSec() +
+			  std::chrono::duration_cast<std::chrono::nanoseconds>
+			  (expected - timer->start).count());
+    timer->queue->addCallback(ros::CallbackInterfacePtr(new TimerTick(timer, expected,
+								      ros_expected)),
+			      timer->owner_id);
+    if (Timeline::instance().enabled())
+      Timeline::instance().instant(timer->timeline_name, "timer", now, "lateness_ns",
+				   std::chrono::duration_cast<std::chrono::nanoseconds>
+				   (now - expected).count());
+
+    if (timer->once)
+      continue;
+
+    // Skip to the first expiry still ahead, rather than catching up
+    timer->next++;
+    if (expiry(*timer) <= now) {
+      uint64_t ahead = (now - timer->start) / timer->period + 1;
+      timer->stats.overruns += ahead - timer->next;
+      timer->next = ahead;
+    }
+    schedule_.insert(std::make_pair(expiry(*timer), timer));
+  }
+}
+
+// Take a timer off the schedule; called with mutex_ held. Returns true if it
+// was the earliest expiry, so the timerfd needs rearming.
+bool TimerEngine::unschedule(const PeriodicTimerPtr& timer) {
+  std::pair<Schedule::iterator, Schedule::iterator> range =
+    schedule_.equal_range(expiry(*timer));
+  for (Schedule::iterator it = range.first; it != range.second; ++it) {
+    if (it->second == timer) {
+      bool earliest = it == schedule_.begin();
+      schedule_.erase(it);
+      return earliest;
+    }
+  }
+  return false;
+}
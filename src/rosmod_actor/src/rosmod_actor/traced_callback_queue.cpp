@@ -0,0 +1,72 @@
+/** @file    traced_callback_queue.cpp
+ *  @date    October 2026
+ *  @brief   This file contains definitions for the component queue firing the queue tracepoints
+ */
+
+// The queue probes have semaphores, set while a tracer is attached
+#define _SDT_HAS_SEMAPHORES 1
+#include "rosmod_actor/traced_callback_queue.hpp"
+#include "rosmod_actor/timeline.hpp"
+#include "rosmod_actor/tracepoints.hpp"
+
+#ifdef ROSMOD_ACTOR_USDT
+#define ROSMOD_SEMAPHORE(name)						\
+  unsigned short rosmod_actor_##name##_semaphore			\
+  __attribute__((unused)) __attribute__((section(".probes")))
+ROSMOD_SEMAPHORE(callback_enqueue);
+ROSMOD_SEMAPHORE(dispatch_begin);
+ROSMOD_SEMAPHORE(dispatch_end);
+#define ROSMOD_TRACING(name) (rosmod_actor_##name##_semaphore != 0)
+#else
+#define ROSMOD_TRACING(name) false
+#endif
+
+namespace {
+
+/**
+ * @brief Queued callback firing the dispatch probes around the original,
+ *        and recording it on the timeline.
+ */
+class TracedCallback : public ros::CallbackInterface {
+public:
+  TracedCallback(const ros::CallbackInterfacePtr& callback, const std::string& name)
+    : callback_(callback), name_(name), queued_(Timeline::Clock::now()) {}
+
+  virtual CallResult call() {
+    Timeline& timeline = Timeline::instance();
+    Timeline::Clock::time_point start = Timeline::Clock::now();
+    ROSMOD_TRACE2(dispatch_begin, name_.c_str(), callback_.get());
+    CallResult result = callback_->call();
+    ROSMOD_TRACE2(dispatch_end, name_.c_str(), callback_.get());
+    if (timeline.enabled())
+      timeline.span("\"callback\"", "queue", start, Timeline::Clock::now(), "queue_wait_ns",
+		    std::chrono::duration_cast<std::chrono::nanoseconds>(start - queued_).count());
+    return result;
+  }
+
+  virtual bool ready() {
+    return callback_->ready();
+  }
+
+private:
+  ros::CallbackInterfacePtr callback_;
+  std::string name_;
+  Timeline::Clock::time_point queued_;
+};
+
+}  // namespace
+
+void TracedCallbackQueue::set_name(const std::string& name) {
+  name_ = name;
+}
+
+void TracedCallbackQueue::addCallback(const ros::CallbackInterfacePtr& callback,
+				      uint64_t owner_id) {
+  ROSMOD_TRACE2(callback_enqueue, name_.c_str(), callback.get());
+  if (ROSMOD_TRACING(dispatch_begin) || ROSMOD_TRACING(dispatch_end) ||
+      Timeline::instance().enabled())
+    ros::CallbackQueue::addCallback(ros::CallbackInterfacePtr(new TracedCallback(callback, name_)),
+				    owner_id);
+  else
+    ros::CallbackQueue::addCallback(callback, owner_id);
+}